@@ -0,0 +1,1103 @@
+#include "../filmdb.h"
+#include "../tdas/concurrent_map.h"
+#include "../tdas/extra.h"
+#include "../tdas/list.h"
+#include "../tdas/map.h"
+#include "../tdas/priority_queue.h"
+#include "../tdas/vector.h"
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+// Archivo del que se toman las filas de los catálogos de prueba
+#define RUTA_CSV "data/Top1500.csv"
+
+// Tamaño máximo por defecto (10^N elementos) y el máximo aceptado
+#define EXP_POR_DEFECTO 6
+#define EXP_MAXIMO 7
+
+// Los casos cuadráticos (p. ej. list_sortedInsert o map_insert en un mapa no
+// ordenado sin hash) solo se miden hasta este tamaño
+#define N_MAX_LENTO 10000
+
+// Cada caso se repite hasta sumar al menos esta cantidad de operaciones, para
+// que los tamaños pequeños no queden dominados por el ruido del reloj
+#define OPS_MINIMAS 100000
+
+// Consultas por caso y claves distintas que se van alternando
+#define N_CONSULTAS 2000
+#define N_CLAVES 64
+
+// Umbral por defecto (en %) para marcar una regresión al comparar
+#define UMBRAL_POR_DEFECTO 10.0
+
+#define MAX_NOMBRE 48
+
+// Resultado de un caso para un tamaño dado
+typedef struct {
+  char nombre[MAX_NOMBRE];
+  long n;
+  double ns_op;     // Nanosegundos por operación
+  double allocs_op; // Asignaciones (malloc/calloc/realloc) por operación
+  long rss_kb;      // Memoria residente máxima del proceso que midió el caso
+} Resultado;
+
+/* ---------- Conteo de asignaciones ---------- */
+
+// Con glibc se reemplazan malloc, calloc y realloc por versiones que cuentan
+// las llamadas (incluidas las de los TDAs y filmdb) y luego llaman a las de la
+// biblioteca. En otras bibliotecas de C no se cuentan las asignaciones.
+#ifdef __GLIBC__
+#define CUENTA_ASIGNACIONES 1
+
+extern void *__libc_malloc(size_t tam);
+extern void *__libc_calloc(size_t n, size_t tam);
+extern void *__libc_realloc(void *ptr, size_t tam);
+
+static unsigned long asignaciones = 0;
+
+void *malloc(size_t tam) {
+  __atomic_fetch_add(&asignaciones, 1, __ATOMIC_RELAXED);
+  return __libc_malloc(tam);
+}
+
+void *calloc(size_t n, size_t tam) {
+  __atomic_fetch_add(&asignaciones, 1, __ATOMIC_RELAXED);
+  return __libc_calloc(n, tam);
+}
+
+void *realloc(void *ptr, size_t tam) {
+  __atomic_fetch_add(&asignaciones, 1, __ATOMIC_RELAXED);
+  return __libc_realloc(ptr, tam);
+}
+
+static unsigned long leer_asignaciones() {
+  return __atomic_load_n(&asignaciones, __ATOMIC_RELAXED);
+}
+#else
+#define CUENTA_ASIGNACIONES 0
+static unsigned long leer_asignaciones() { return 0; }
+#endif
+
+/* ---------- Medición ---------- */
+
+// Tiempo y asignaciones acumulados de un caso (solo dentro de las zonas
+// medidas, sin contar la preparación de los datos)
+typedef struct {
+  double ns;
+  unsigned long asignaciones;
+  long ops;
+  struct timespec t0;
+  unsigned long a0;
+} Medicion;
+
+static void medir_inicio(Medicion *m) {
+  m->a0 = leer_asignaciones();
+  clock_gettime(CLOCK_MONOTONIC, &m->t0);
+}
+
+static void medir_fin(Medicion *m, long ops) {
+  struct timespec t1;
+  clock_gettime(CLOCK_MONOTONIC, &t1);
+  m->asignaciones += leer_asignaciones() - m->a0;
+  m->ns += (t1.tv_sec - m->t0.tv_sec) * 1e9 + (t1.tv_nsec - m->t0.tv_nsec);
+  m->ops += ops;
+}
+
+// Repeticiones de un caso de n operaciones para llegar a OPS_MINIMAS
+static long repeticiones(long n) {
+  return n >= OPS_MINIMAS ? 1 : (OPS_MINIMAS + n - 1) / n;
+}
+
+// Evita que el compilador elimine las operaciones cuyo resultado no se usa
+static volatile long sumidero;
+
+/**
+ * Envía el resultado de un caso al proceso padre por el descriptor `fd`.
+ */
+static void reportar(int fd, const char *nombre, long n, Medicion *m) {
+  Resultado r = {{0}};
+  snprintf(r.nombre, sizeof(r.nombre), "%s", nombre);
+  r.n = n;
+  r.ns_op = m->ops ? m->ns / m->ops : 0;
+  r.allocs_op = CUENTA_ASIGNACIONES && m->ops
+                    ? (double)m->asignaciones / m->ops
+                    : NAN;
+  if (write(fd, &r, sizeof(r)) != sizeof(r))
+    exit(EXIT_FAILURE);
+}
+
+/* ---------- Claves de prueba ---------- */
+
+static unsigned long semilla_claves = 88172645463325252UL;
+
+// Generador xorshift64 (determinista, para que dos corridas usen las mismas
+// claves)
+static unsigned long aleatorio() {
+  semilla_claves ^= semilla_claves << 13;
+  semilla_claves ^= semilla_claves >> 7;
+  semilla_claves ^= semilla_claves << 17;
+  return semilla_claves;
+}
+
+// Retorna los enteros 0..n-1 en orden aleatorio
+static int *claves_desordenadas(long n) {
+  int *claves = malloc(n * sizeof(int));
+  if (claves == NULL) {
+    perror("Error al reservar memoria");
+    exit(EXIT_FAILURE);
+  }
+  for (long i = 0; i < n; i++)
+    claves[i] = i;
+  for (long i = n - 1; i > 0; i--) {
+    long j = aleatorio() % (i + 1);
+    int t = claves[i];
+    claves[i] = claves[j];
+    claves[j] = t;
+  }
+  return claves;
+}
+
+static int is_equal_int(void *key1, void *key2) {
+  return *(int *)key1 == *(int *)key2;
+}
+
+static int lower_than_int(void *key1, void *key2) {
+  return *(int *)key1 < *(int *)key2;
+}
+
+// Mezcla los bits del entero (finalizador de MurmurHash3)
+static unsigned long hash_int(void *key) {
+  unsigned long h = (unsigned int)*(int *)key;
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdUL;
+  h ^= h >> 33;
+  return h;
+}
+
+// Hilos para la carga de catálogos y los casos con varios hilos
+static int hilos_disponibles() {
+  long hilos = sysconf(_SC_NPROCESSORS_ONLN);
+  return hilos > 0 ? hilos : 1;
+}
+
+/* ---------- Casos de los TDAs ---------- */
+
+// Un caso mide una operación sobre una estructura de n elementos y reporta
+// tantos resultados como quiera por `fd`
+typedef void (*FuncionCaso)(int fd, long n);
+
+static void caso_list_push(int fd, long n) {
+  Medicion atras = {0}, adelante = {0}, recorrer = {0};
+  int *claves = claves_desordenadas(n);
+  for (long r = repeticiones(n); r > 0; r--) {
+    List *L = list_create();
+    medir_inicio(&atras);
+    for (long i = 0; i < n; i++)
+      list_pushBack(L, &claves[i]);
+    medir_fin(&atras, n);
+
+    long suma = 0;
+    medir_inicio(&recorrer);
+    for (int *k = list_first(L); k != NULL; k = list_next(L))
+      suma += *k;
+    medir_fin(&recorrer, n);
+    sumidero = suma;
+    list_clean(L);
+
+    medir_inicio(&adelante);
+    for (long i = 0; i < n; i++)
+      list_pushFront(L, &claves[i]);
+    medir_fin(&adelante, n);
+    list_clean(L);
+    free(L);
+  }
+  reportar(fd, "list_pushBack", n, &atras);
+  reportar(fd, "list_pushFront", n, &adelante);
+  reportar(fd, "list_iterate", n, &recorrer);
+  free(claves);
+}
+
+static void caso_list_pop(int fd, long n) {
+  Medicion frente = {0}, atras = {0};
+  int *claves = claves_desordenadas(n);
+  for (long r = repeticiones(n); r > 0; r--) {
+    List *L = list_create();
+    for (long i = 0; i < n; i++)
+      list_pushBack(L, &claves[i]);
+    medir_inicio(&frente);
+    while (list_popFront(L) != NULL)
+      ;
+    medir_fin(&frente, n);
+
+    for (long i = 0; i < n; i++)
+      list_pushBack(L, &claves[i]);
+    medir_inicio(&atras);
+    while (list_popBack(L) != NULL)
+      ;
+    medir_fin(&atras, n);
+    list_clean(L);
+    free(L);
+  }
+  reportar(fd, "list_popFront", n, &frente);
+  reportar(fd, "list_popBack", n, &atras);
+  free(claves);
+}
+
+static void caso_list_sorted_insert(int fd, long n) {
+  Medicion m = {0};
+  int *claves = claves_desordenadas(n);
+  for (long r = repeticiones(n); r > 0; r--) {
+    List *L = list_create();
+    medir_inicio(&m);
+    for (long i = 0; i < n; i++)
+      list_sortedInsert(L, &claves[i], lower_than_int);
+    medir_fin(&m, n);
+    list_clean(L);
+    free(L);
+  }
+  reportar(fd, "list_sortedInsert", n, &m);
+  free(claves);
+}
+
+static void caso_vector(int fd, long n) {
+  Medicion atras = {0}, recorrer = {0}, ordenar = {0}, sacar = {0};
+  int *claves = claves_desordenadas(n);
+  for (long r = repeticiones(n); r > 0; r--) {
+    Vector *V = vector_create();
+    medir_inicio(&atras);
+    for (long i = 0; i < n; i++)
+      vector_pushBack(V, &claves[i]);
+    medir_fin(&atras, n);
+
+    long suma = 0;
+    medir_inicio(&recorrer);
+    for (int *k = vector_first(V); k != NULL; k = vector_next(V))
+      suma += *k;
+    medir_fin(&recorrer, n);
+    sumidero = suma;
+
+    medir_inicio(&ordenar);
+    vector_sort(V, lower_than_int);
+    medir_fin(&ordenar, n);
+
+    medir_inicio(&sacar);
+    while (vector_popBack(V) != NULL)
+      ;
+    medir_fin(&sacar, n);
+    vector_clean(V);
+    free(V);
+  }
+  reportar(fd, "vector_pushBack", n, &atras);
+  reportar(fd, "vector_iterate", n, &recorrer);
+  reportar(fd, "vector_sort", n, &ordenar);
+  reportar(fd, "vector_popBack", n, &sacar);
+  free(claves);
+}
+
+// Mide inserción, búsqueda (con y sin éxito), recorrido y eliminación en un
+// mapa creado con `crear`. Los nombres de los casos llevan el prefijo dado.
+static void medir_mapa(int fd, long n, const char *prefijo,
+                       Map *(*crear)(void)) {
+  Medicion insertar = {0}, buscar = {0}, fallar = {0}, recorrer = {0},
+           eliminar = {0};
+  int *claves = claves_desordenadas(n);
+  int *ausentes = malloc(n * sizeof(int));
+  for (long i = 0; i < n; i++)
+    ausentes[i] = n + claves[i];
+
+  for (long r = repeticiones(n); r > 0; r--) {
+    Map *map = crear();
+    medir_inicio(&insertar);
+    for (long i = 0; i < n; i++)
+      map_insert(map, &claves[i], &claves[i]);
+    medir_fin(&insertar, n);
+
+    long encontrados = 0;
+    medir_inicio(&buscar);
+    for (long i = n - 1; i >= 0; i--)
+      encontrados += map_search(map, &claves[i]) != NULL;
+    medir_fin(&buscar, n);
+
+    medir_inicio(&fallar);
+    for (long i = 0; i < n; i++)
+      encontrados += map_search(map, &ausentes[i]) != NULL;
+    medir_fin(&fallar, n);
+
+    long suma = 0;
+    medir_inicio(&recorrer);
+    for (MapPair *p = map_first(map); p != NULL; p = map_next(map))
+      suma += *(int *)p->key;
+    medir_fin(&recorrer, n);
+    sumidero = encontrados + suma;
+
+    medir_inicio(&eliminar);
+    for (long i = 0; i < n; i++)
+      free(map_remove(map, &claves[i]));
+    medir_fin(&eliminar, n);
+    map_clean(map);
+    free(map);
+  }
+
+  char nombre[MAX_NOMBRE];
+  snprintf(nombre, sizeof(nombre), "%s_insert", prefijo);
+  reportar(fd, nombre, n, &insertar);
+  snprintf(nombre, sizeof(nombre), "%s_search", prefijo);
+  reportar(fd, nombre, n, &buscar);
+  snprintf(nombre, sizeof(nombre), "%s_search_miss", prefijo);
+  reportar(fd, nombre, n, &fallar);
+  snprintf(nombre, sizeof(nombre), "%s_iterate", prefijo);
+  reportar(fd, nombre, n, &recorrer);
+  snprintf(nombre, sizeof(nombre), "%s_remove", prefijo);
+  reportar(fd, nombre, n, &eliminar);
+  free(ausentes);
+  free(claves);
+}
+
+static Map *crear_map() { return map_create(is_equal_int); }
+static Map *crear_hash_map() { return hash_map_create(hash_int, is_equal_int); }
+static Map *crear_sorted_map() { return sorted_map_create(lower_than_int); }
+
+static void caso_map(int fd, long n) { medir_mapa(fd, n, "map", crear_map); }
+
+static void caso_hash_map(int fd, long n) {
+  medir_mapa(fd, n, "hash_map", crear_hash_map);
+}
+
+static void caso_sorted_map(int fd, long n) {
+  medir_mapa(fd, n, "sorted_map", crear_sorted_map);
+
+  // Búsqueda del primer par no menor que una clave (las claves pares están en
+  // el mapa y se buscan las impares)
+  Medicion cota = {0};
+  int *claves = claves_desordenadas(n);
+  for (long i = 0; i < n; i++)
+    claves[i] *= 2;
+  for (long r = repeticiones(n); r > 0; r--) {
+    Map *map = sorted_map_create(lower_than_int);
+    for (long i = 0; i < n; i++)
+      map_insert(map, &claves[i], NULL);
+    long encontrados = 0;
+    medir_inicio(&cota);
+    for (long i = 0; i < n; i++) {
+      int k = claves[i] - 1;
+      encontrados += map_lower_bound(map, &k) != NULL;
+    }
+    medir_fin(&cota, n);
+    sumidero = encontrados;
+    map_clean(map);
+    free(map);
+  }
+  reportar(fd, "sorted_map_lower_bound", n, &cota);
+  free(claves);
+}
+
+// Búsquedas de un hilo en un mapa concurrente compartido
+typedef struct {
+  ConcurrentMap *map;
+  int *claves;
+  long n;
+  long encontrados;
+} BusquedaConcurrente;
+
+static void *buscar_concurrente(void *arg) {
+  BusquedaConcurrente *b = arg;
+  void *valor;
+  for (long i = 0; i < b->n; i++)
+    b->encontrados += concurrent_map_get(b->map, &b->claves[i], &valor);
+  return NULL;
+}
+
+// Mide el mapa concurrente con un hilo y la búsqueda con todos los hilos a la
+// vez sobre el mismo mapa; con varios hilos el tiempo por operación es el
+// tiempo total dividido por las búsquedas de todos los hilos.
+static void caso_concurrent_map(int fd, long n) {
+  Medicion insertar = {0}, buscar = {0}, buscar_hilos = {0}, eliminar = {0};
+  int hilos = hilos_disponibles();
+  int *claves = claves_desordenadas(n);
+  BusquedaConcurrente *busquedas =
+      (BusquedaConcurrente *)malloc(hilos * sizeof(BusquedaConcurrente));
+  pthread_t *ids = (pthread_t *)malloc(hilos * sizeof(pthread_t));
+  for (long r = repeticiones(n); r > 0; r--) {
+    ConcurrentMap *map = concurrent_map_create(hash_int, is_equal_int, 0);
+    medir_inicio(&insertar);
+    for (long i = 0; i < n; i++)
+      concurrent_map_insert(map, &claves[i], NULL);
+    medir_fin(&insertar, n);
+
+    for (int h = 0; h < hilos; h++)
+      busquedas[h] = (BusquedaConcurrente){map, claves, n, 0};
+    medir_inicio(&buscar);
+    buscar_concurrente(&busquedas[0]);
+    medir_fin(&buscar, n);
+
+    medir_inicio(&buscar_hilos);
+    for (int h = 1; h < hilos; h++)
+      pthread_create(&ids[h], NULL, buscar_concurrente, &busquedas[h]);
+    buscar_concurrente(&busquedas[0]);
+    for (int h = 1; h < hilos; h++)
+      pthread_join(ids[h], NULL);
+    medir_fin(&buscar_hilos, n * hilos);
+    sumidero = busquedas[0].encontrados;
+
+    medir_inicio(&eliminar);
+    for (long i = 0; i < n; i++)
+      free(concurrent_map_remove(map, &claves[i]));
+    medir_fin(&eliminar, n);
+    concurrent_map_clean(map);
+    free(map);
+  }
+  reportar(fd, "concurrent_map_insert", n, &insertar);
+  reportar(fd, "concurrent_map_get", n, &buscar);
+  reportar(fd, "concurrent_map_get_mt", n, &buscar_hilos);
+  reportar(fd, "concurrent_map_remove", n, &eliminar);
+  free(busquedas);
+  free(ids);
+  free(claves);
+}
+
+static void caso_pqueue(int fd, long n) {
+  Medicion insertar = {0}, remover = {0}, heapify = {0};
+  int *claves = claves_desordenadas(n);
+  void **datos = (void **)malloc(n * sizeof(void *));
+  for (long i = 0; i < n; i++)
+    datos[i] = &claves[i];
+  for (long r = repeticiones(n); r > 0; r--) {
+    PQueue *pq = pqueue_create(NULL);
+    medir_inicio(&insertar);
+    for (long i = 0; i < n; i++)
+      pqueue_insert(pq, claves[i], &claves[i]);
+    medir_fin(&insertar, n);
+
+    medir_inicio(&remover);
+    while (pqueue_remove(pq) != NULL)
+      ;
+    medir_fin(&remover, n);
+
+    medir_inicio(&heapify);
+    pqueue_heapify(pq, claves, datos, n);
+    medir_fin(&heapify, n);
+    pqueue_clean(pq);
+    free(pq);
+  }
+  reportar(fd, "pqueue_insert", n, &insertar);
+  reportar(fd, "pqueue_remove", n, &remover);
+  reportar(fd, "pqueue_heapify", n, &heapify);
+  free(datos);
+  free(claves);
+}
+
+/* ---------- Casos del catálogo de películas ---------- */
+
+#define N_COLUMNAS 15
+
+// Filas del CSV de origen, de las que se arman los catálogos de prueba. Solo
+// se leen en el proceso que escribe cada catálogo, para no inflar la memoria
+// residente de los procesos que miden los casos.
+static const char *ruta_origen = RUTA_CSV;
+static ArchivoCSV *origen = NULL;
+static CampoCSV (*filas_origen)[N_COLUMNAS] = NULL;
+static long n_filas_origen = 0;
+static CampoCSV cabecera_origen[N_COLUMNAS];
+
+// Directorio temporal con los catálogos de prueba
+static char dir_temporal[] = "/tmp/bench-XXXXXX";
+
+/**
+ * Lee las filas del CSV de origen. Los catálogos de prueba se arman
+ * repitiéndolas (ver escribir_catalogo).
+ */
+static void leer_origen(const char *ruta) {
+  origen = csv_abrir(ruta);
+  if (origen == NULL) {
+    perror("Error al abrir el archivo");
+    exit(EXIT_FAILURE);
+  }
+  if (csv_leer_linea(origen, ',', cabecera_origen, N_COLUMNAS) != N_COLUMNAS) {
+    fprintf(stderr, "%s no tiene el formato de IMDb\n", ruta);
+    exit(EXIT_FAILURE);
+  }
+  long capacidad = 1024;
+  filas_origen = malloc(capacidad * sizeof(*filas_origen));
+  while (csv_leer_linea(origen, ',', filas_origen[n_filas_origen],
+                        N_COLUMNAS) == N_COLUMNAS) {
+    if (++n_filas_origen == capacidad) {
+      capacidad *= 2;
+      filas_origen = realloc(filas_origen, capacidad * sizeof(*filas_origen));
+    }
+  }
+  if (n_filas_origen == 0) {
+    fprintf(stderr, "%s no tiene películas\n", ruta);
+    exit(EXIT_FAILURE);
+  }
+}
+
+// Escribe un campo de CSV, entre comillas si contiene el separador, comillas
+// o saltos de línea
+static void escribir_campo(FILE *f, const char *campo, size_t len) {
+  if (strcspn(campo, ",\"\n") >= len) {
+    fwrite(campo, 1, len, f);
+    return;
+  }
+  fputc('"', f);
+  for (size_t i = 0; i < len; i++) {
+    if (campo[i] == '"')
+      fputc('"', f);
+    fputc(campo[i], f);
+  }
+  fputc('"', f);
+}
+
+/**
+ * Escribe en `ruta` un catálogo de n películas tomando las filas del CSV de
+ * origen en orden (y volviendo a empezar al terminarlas). Cada fila recibe una
+ * posición y un id nuevos, de modo que los ids no se repiten; los directores,
+ * géneros y años sí, como en un catálogo real más grande.
+ */
+static void escribir_catalogo(const char *ruta, long n) {
+  FILE *f = fopen(ruta, "w");
+  if (f == NULL) {
+    perror("Error al crear el catálogo de prueba");
+    exit(EXIT_FAILURE);
+  }
+  setvbuf(f, NULL, _IOFBF, 1 << 20);
+  for (int c = 0; c < N_COLUMNAS; c++) {
+    if (c > 0)
+      fputc(',', f);
+    escribir_campo(f, cabecera_origen[c].ptr, cabecera_origen[c].len);
+  }
+  fputc('\n', f);
+  for (long i = 0; i < n; i++) {
+    CampoCSV *fila = filas_origen[i % n_filas_origen];
+    fprintf(f, "%ld,tt%08ld", i + 1, i + 1);
+    for (int c = 2; c < N_COLUMNAS; c++) {
+      fputc(',', f);
+      escribir_campo(f, fila[c].ptr, fila[c].len);
+    }
+    fputc('\n', f);
+  }
+  if (fclose(f) != 0) {
+    perror("Error al escribir el catálogo de prueba");
+    exit(EXIT_FAILURE);
+  }
+}
+
+static void ruta_catalogo(char *ruta, size_t tam, long n) {
+  snprintf(ruta, tam, "%s/peliculas_%ld.csv", dir_temporal, n);
+}
+
+// Escribe el catálogo de prueba de n películas (no reporta resultados)
+static void caso_escribir_catalogo(int fd, long n) {
+  (void)fd;
+  char ruta[256];
+  ruta_catalogo(ruta, sizeof(ruta), n);
+  leer_origen(ruta_origen);
+  escribir_catalogo(ruta, n);
+}
+
+static void ruta_instantanea(char *ruta, size_t tam, long n) {
+  snprintf(ruta, tam, "%s/peliculas_%ld.csv.snap", dir_temporal, n);
+}
+
+// Carga un catálogo, terminando el proceso si no se puede
+static FilmDB *cargar_catalogo(const char *ruta) {
+  FilmDB *db = filmdb_create();
+  if (db == NULL || filmdb_load(db, ruta, hilos_disponibles()) != FILMDB_OK) {
+    fprintf(stderr, "No se pudo cargar %s\n", ruta);
+    exit(EXIT_FAILURE);
+  }
+  return db;
+}
+
+static void liberar_catalogo(FilmDB *db) {
+  filmdb_clean(db);
+  free(db);
+}
+
+/**
+ * Mide la separación de campos del CSV, la carga del catálogo desde el CSV
+ * (incluye guardar la instantánea) y la carga desde la instantánea. Las tres
+ * se reportan por fila.
+ */
+static void caso_carga(int fd, long n) {
+  char ruta[256], instantanea[256];
+  ruta_catalogo(ruta, sizeof(ruta), n);
+  ruta_instantanea(instantanea, sizeof(instantanea), n);
+
+  Medicion separar = {0}, cargar = {0}, mapear = {0};
+  CampoCSV campos[N_COLUMNAS];
+  for (long r = repeticiones(n); r > 0; r--) {
+    long filas = 0;
+    medir_inicio(&separar);
+    ArchivoCSV *csv = csv_abrir(ruta);
+    while (csv_leer_linea(csv, ',', campos, N_COLUMNAS) != -1)
+      filas++;
+    csv_cerrar(csv);
+    medir_fin(&separar, n);
+    sumidero = filas;
+
+    unlink(instantanea);
+    medir_inicio(&cargar);
+    FilmDB *db = cargar_catalogo(ruta);
+    medir_fin(&cargar, n);
+    liberar_catalogo(db);
+
+    medir_inicio(&mapear);
+    db = cargar_catalogo(ruta);
+    medir_fin(&mapear, n);
+    liberar_catalogo(db);
+  }
+  reportar(fd, "csv_parse", n, &separar);
+  reportar(fd, "filmdb_load_csv", n, &cargar);
+  reportar(fd, "filmdb_load_snapshot", n, &mapear);
+}
+
+// Copia a lo más `max` bytes de src en dst, sin cortar caracteres UTF-8
+static void copiar_caracteres(char *dst, const char *src, size_t max) {
+  size_t l = strnlen(src, max);
+  while (l > 0 && (src[l] & 0xc0) == 0x80)
+    l--;
+  memcpy(dst, src, l);
+  dst[l] = '\0';
+}
+
+// Copia a dst (de tamaño max) el texto src con un byte ASCII de su mitad
+// cambiado, como una errata
+static void agregar_errata(char *dst, const char *src, size_t max) {
+  snprintf(dst, max, "%s", src);
+  size_t i = strlen(dst) / 2;
+  while (dst[i] != '\0' && (dst[i] & 0x80))
+    i++;
+  if (dst[i] != '\0')
+    dst[i] = dst[i] == 'x' ? 'y' : 'x';
+}
+
+// Ejecuta N_CONSULTAS consultas alternando entre las dadas
+static void medir_consultas(int fd, FilmDB *db, long n, const char *nombre,
+                            FilmQuery *consultas, int n_consultas) {
+  Medicion m = {0};
+  long total = 0;
+  medir_inicio(&m);
+  for (int i = 0; i < N_CONSULTAS; i++) {
+    FilmResult res;
+    if (!filmdb_query(db, &consultas[i % n_consultas], &res)) {
+      fprintf(stderr, "No hay memoria para la consulta %s\n", nombre);
+      exit(EXIT_FAILURE);
+    }
+    total += res.total;
+    filmdb_result_clean(&res);
+  }
+  medir_fin(&m, N_CONSULTAS);
+  sumidero = total;
+  reportar(fd, nombre, n, &m);
+}
+
+/**
+ * Mide cada tipo de consulta sobre un catálogo de n películas. Las claves se
+ * toman de películas repartidas por todo el catálogo, así que las consultas
+ * encuentran resultados.
+ */
+static void caso_consultas(int fd, long n) {
+  char ruta[256];
+  ruta_catalogo(ruta, sizeof(ruta), n);
+  FilmDB *db = cargar_catalogo(ruta);
+
+  FilmQuery id[N_CLAVES], director[N_CLAVES], genero[N_CLAVES],
+      ambos[N_CLAVES], alguno[N_CLAVES], decada[N_CLAVES], rating[N_CLAVES],
+      director_decada[N_CLAVES], genero_decada[N_CLAVES], titulo[N_CLAVES],
+      prefijo[N_CLAVES], director_aprox[N_CLAVES], titulo_aprox[N_CLAVES];
+  char combinados[2][N_CLAVES][128], partes[2][N_CLAVES][8];
+  char erratas[2][N_CLAVES][128];
+  long paso = n / N_CLAVES > 0 ? n / N_CLAVES : 1;
+  for (int k = 0; k < N_CLAVES; k++) {
+    int f = (k * paso + k) % n;
+    const char *generos[FILMDB_MAX_GENRES];
+    int n_generos = filmdb_genres(db, f, generos);
+    const char *g1 = n_generos > 0 ? generos[0] : "Drama";
+    const char *g2 = n_generos > 1 ? generos[1] : g1;
+    snprintf(combinados[0][k], 128, "%s+%s", g1, g2);
+    snprintf(combinados[1][k], 128, "%s|%s", g1, g2);
+    float r = filmdb_rating(db, f);
+    // Parte del título: unos bytes de su mitad; comienzo: los primeros
+    const char *t = filmdb_title(db, f), *medio = t + strlen(t) / 2;
+    while ((*medio & 0xc0) == 0x80)
+      medio++;
+    copiar_caracteres(partes[0][k], medio, 5);
+    copiar_caracteres(partes[1][k], t, 4);
+
+    id[k] = (FilmQuery){FILMDB_ID, .id = filmdb_id(db, f)};
+    director[k] =
+        (FilmQuery){FILMDB_DIRECTOR, .director = filmdb_director(db, f)};
+    genero[k] = (FilmQuery){FILMDB_GENRE, .genero = g1};
+    ambos[k] = (FilmQuery){FILMDB_GENRE, .genero = combinados[0][k]};
+    alguno[k] = (FilmQuery){FILMDB_GENRE, .genero = combinados[1][k]};
+    decada[k] = (FilmQuery){FILMDB_DECADE, .decada = filmdb_year(db, f)};
+    rating[k] = (FilmQuery){FILMDB_RATING, .rating_min = r - 0.2f,
+                            .rating_max = r};
+    director_decada[k] = director[k];
+    director_decada[k].criterios |= FILMDB_DECADE;
+    director_decada[k].decada = decada[k].decada;
+    genero_decada[k] = genero[k];
+    genero_decada[k].criterios |= FILMDB_DECADE;
+    genero_decada[k].decada = decada[k].decada;
+    titulo[k] = (FilmQuery){FILMDB_TITLE, .titulo = partes[0][k]};
+    prefijo[k] = (FilmQuery){FILMDB_TITLE_PREFIX, .prefijo = partes[1][k]};
+    // Búsquedas aproximadas: el director y el título con una errata
+    agregar_errata(erratas[0][k], filmdb_director(db, f), 128);
+    agregar_errata(erratas[1][k], t, 128);
+    director_aprox[k] = (FilmQuery){FILMDB_DIRECTOR | FILMDB_FUZZY,
+                                    .director = erratas[0][k]};
+    titulo_aprox[k] =
+        (FilmQuery){FILMDB_TITLE | FILMDB_FUZZY, .titulo = erratas[1][k]};
+  }
+
+  medir_consultas(fd, db, n, "query_id", id, N_CLAVES);
+  medir_consultas(fd, db, n, "query_director", director, N_CLAVES);
+  medir_consultas(fd, db, n, "query_genre", genero, N_CLAVES);
+  medir_consultas(fd, db, n, "query_genre_all", ambos, N_CLAVES);
+  medir_consultas(fd, db, n, "query_genre_any", alguno, N_CLAVES);
+  medir_consultas(fd, db, n, "query_decade", decada, N_CLAVES);
+  medir_consultas(fd, db, n, "query_rating", rating, N_CLAVES);
+  medir_consultas(fd, db, n, "query_director_decade", director_decada,
+                  N_CLAVES);
+  medir_consultas(fd, db, n, "query_genre_decade", genero_decada, N_CLAVES);
+
+  // La primera consulta por título construye el índice de títulos
+  Medicion indice = {0};
+  FilmResult res;
+  medir_inicio(&indice);
+  filmdb_query(db, &titulo[0], &res);
+  medir_fin(&indice, n);
+  filmdb_result_clean(&res);
+  reportar(fd, "title_index_build", n, &indice);
+  medir_consultas(fd, db, n, "query_title", titulo, N_CLAVES);
+  medir_consultas(fd, db, n, "query_title_prefix", prefijo, N_CLAVES);
+
+  // Igual con los índices de trigramas de las búsquedas aproximadas
+  Medicion trigramas = {0};
+  medir_inicio(&trigramas);
+  filmdb_query(db, &director_aprox[0], &res);
+  filmdb_result_clean(&res);
+  filmdb_query(db, &titulo_aprox[0], &res);
+  filmdb_result_clean(&res);
+  medir_fin(&trigramas, n);
+  reportar(fd, "trigram_index_build", n, &trigramas);
+  medir_consultas(fd, db, n, "query_director_fuzzy", director_aprox, N_CLAVES);
+  medir_consultas(fd, db, n, "query_title_fuzzy", titulo_aprox, N_CLAVES);
+  liberar_catalogo(db);
+}
+
+/* ---------- Ejecución ---------- */
+
+typedef struct {
+  FuncionCaso funcion;
+  long n_max; // 0 si no tiene límite
+} Caso;
+
+static const Caso casos_tdas[] = {
+    {caso_list_push, 0},
+    {caso_list_pop, 0},
+    {caso_list_sorted_insert, N_MAX_LENTO},
+    {caso_vector, 0},
+    {caso_map, N_MAX_LENTO},
+    {caso_hash_map, 0},
+    {caso_sorted_map, 0},
+    {caso_concurrent_map, 0},
+    {caso_pqueue, 0},
+};
+
+static const Caso casos_peliculas[] = {
+    {caso_carga, 0},
+    {caso_consultas, 0},
+};
+
+static Resultado *resultados = NULL;
+static int n_resultados = 0, cap_resultados = 0;
+
+/**
+ * Ejecuta un caso en un proceso hijo, de modo que cada caso parte con la
+ * memoria limpia y su memoria residente máxima se puede medir por separado.
+ * Los resultados que envía el hijo se agregan a `resultados`.
+ */
+static void ejecutar_caso(FuncionCaso funcion, long n) {
+  int tubo[2];
+  if (pipe(tubo) == -1) {
+    perror("Error al crear el proceso");
+    exit(EXIT_FAILURE);
+  }
+  fflush(stdout);
+  pid_t hijo = fork();
+  if (hijo == -1) {
+    perror("Error al crear el proceso");
+    exit(EXIT_FAILURE);
+  }
+  if (hijo == 0) {
+    close(tubo[0]);
+    funcion(tubo[1], n);
+    _exit(EXIT_SUCCESS);
+  }
+
+  close(tubo[1]);
+  int primero = n_resultados;
+  Resultado r;
+  while (read(tubo[0], &r, sizeof(r)) == sizeof(r)) {
+    if (n_resultados == cap_resultados) {
+      cap_resultados = cap_resultados ? 2 * cap_resultados : 64;
+      resultados = realloc(resultados, cap_resultados * sizeof(Resultado));
+    }
+    resultados[n_resultados++] = r;
+  }
+  close(tubo[0]);
+
+  int estado;
+  struct rusage uso;
+  if (wait4(hijo, &estado, 0, &uso) == -1 || !WIFEXITED(estado) ||
+      WEXITSTATUS(estado) != EXIT_SUCCESS) {
+    fprintf(stderr, "Un caso de tamaño %ld terminó con error\n", n);
+    exit(EXIT_FAILURE);
+  }
+  for (int i = primero; i < n_resultados; i++) {
+    resultados[i].rss_kb = uso.ru_maxrss; // En KB en Linux
+    printf("%-26s %10ld %12.1f ", resultados[i].nombre, resultados[i].n,
+           resultados[i].ns_op);
+    if (isnan(resultados[i].allocs_op))
+      printf("%10s", "-");
+    else
+      printf("%10.2f", resultados[i].allocs_op);
+    printf(" %10ld\n", resultados[i].rss_kb);
+  }
+}
+
+// Escribe un número en JSON (null si no está definido)
+static void escribir_numero(FILE *f, double x) {
+  if (isnan(x))
+    fputs("null", f);
+  else
+    fprintf(f, "%.3f", x);
+}
+
+/**
+ * Guarda los resultados en formato JSON, un resultado por línea (así los lee
+ * comparar_resultados).
+ */
+static void guardar_resultados(const char *ruta) {
+  FILE *f = fopen(ruta, "w");
+  if (f == NULL) {
+    perror("Error al crear el archivo de resultados");
+    exit(EXIT_FAILURE);
+  }
+  char fecha[32];
+  time_t ahora = time(NULL);
+  strftime(fecha, sizeof(fecha), "%Y-%m-%dT%H:%M:%SZ", gmtime(&ahora));
+  fprintf(f, "{\n  \"date\": \"%s\",\n  \"threads\": %d,\n", fecha,
+          hilos_disponibles());
+  fputs("  \"results\": [\n", f);
+  for (int i = 0; i < n_resultados; i++) {
+    Resultado *r = &resultados[i];
+    fprintf(f, "    {\"benchmark\": \"%s\", \"n\": %ld, \"ns_per_op\": ",
+            r->nombre, r->n);
+    escribir_numero(f, r->ns_op);
+    fputs(", \"allocs_per_op\": ", f);
+    escribir_numero(f, r->allocs_op);
+    fprintf(f, ", \"peak_rss_kb\": %ld}%s\n", r->rss_kb,
+            i + 1 < n_resultados ? "," : "");
+  }
+  fputs("  ]\n}\n", f);
+  if (fclose(f) != 0) {
+    perror("Error al escribir el archivo de resultados");
+    exit(EXIT_FAILURE);
+  }
+}
+
+/* ---------- Comparación ---------- */
+
+// Retorna el número que sigue a `"campo":` en la línea (NAN si no está o es
+// null)
+static double leer_campo(const char *linea, const char *campo) {
+  char patron[64];
+  snprintf(patron, sizeof(patron), "\"%s\":", campo);
+  const char *p = strstr(linea, patron);
+  if (p == NULL)
+    return NAN;
+  char *fin;
+  double x = strtod(p + strlen(patron), &fin);
+  return fin == p + strlen(patron) ? NAN : x;
+}
+
+/**
+ * Lee un archivo de resultados escrito por guardar_resultados. Retorna el
+ * número de resultados leídos (que quedan en *salida), o -1 si no se pudo
+ * abrir.
+ */
+static int leer_resultados(const char *ruta, Resultado **salida) {
+  FILE *f = fopen(ruta, "r");
+  if (f == NULL)
+    return -1;
+  Resultado *leidos = NULL;
+  int n = 0, cap = 0;
+  char linea[512];
+  while (fgets(linea, sizeof(linea), f)) {
+    Resultado r = {{0}};
+    if (sscanf(linea, " {\"benchmark\": \"%47[^\"]\"", r.nombre) != 1)
+      continue;
+    r.n = (long)leer_campo(linea, "n");
+    r.ns_op = leer_campo(linea, "ns_per_op");
+    r.allocs_op = leer_campo(linea, "allocs_per_op");
+    r.rss_kb = (long)leer_campo(linea, "peak_rss_kb");
+    if (n == cap) {
+      cap = cap ? 2 * cap : 64;
+      leidos = realloc(leidos, cap * sizeof(Resultado));
+    }
+    leidos[n++] = r;
+  }
+  fclose(f);
+  *salida = leidos;
+  return n;
+}
+
+/**
+ * Compara dos archivos de resultados caso por caso y marca como regresión los
+ * casos del segundo que son más lentos, hacen más asignaciones o usan más
+ * memoria que en el primero por sobre el umbral (en %). Retorna el número de
+ * regresiones.
+ */
+static int comparar_resultados(const char *ruta_base, const char *ruta_nueva,
+                               double umbral) {
+  Resultado *base, *nueva;
+  int n_base = leer_resultados(ruta_base, &base);
+  int n_nueva = leer_resultados(ruta_nueva, &nueva);
+  if (n_base == -1 || n_nueva == -1) {
+    perror("Error al abrir el archivo de resultados");
+    exit(EXIT_FAILURE);
+  }
+
+  double factor = 1 + umbral / 100;
+  int regresiones = 0;
+  printf("%-26s %10s %12s %12s %8s %s\n", "caso", "n", "ns/op base",
+         "ns/op nuevo", "cambio", "");
+  for (int i = 0; i < n_nueva; i++) {
+    Resultado *b = NULL, *r = &nueva[i];
+    for (int j = 0; j < n_base && b == NULL; j++)
+      if (base[j].n == r->n && strcmp(base[j].nombre, r->nombre) == 0)
+        b = &base[j];
+    if (b == NULL)
+      continue;
+
+    const char *motivo = "";
+    if (r->ns_op > b->ns_op * factor)
+      motivo = "REGRESIÓN: tiempo";
+    else if (!isnan(b->allocs_op) && !isnan(r->allocs_op) &&
+             r->allocs_op > b->allocs_op * factor + 0.01)
+      motivo = "REGRESIÓN: asignaciones";
+    else if (r->rss_kb > b->rss_kb * factor)
+      motivo = "REGRESIÓN: memoria";
+    regresiones += motivo[0] != '\0';
+
+    double cambio = b->ns_op > 0 ? 100 * (r->ns_op - b->ns_op) / b->ns_op : 0;
+    printf("%-26s %10ld %12.1f %12.1f %+7.1f%% %s\n", r->nombre, r->n,
+           b->ns_op, r->ns_op, cambio, motivo);
+  }
+  printf("%d regresiones (umbral %.1f%%)\n", regresiones, umbral);
+  free(base);
+  free(nueva);
+  return regresiones;
+}
+
+/* ---------- Programa principal ---------- */
+
+static void uso(const char *programa) {
+  fprintf(stderr,
+          "Uso: %s [-n exponente] [-r csv] [-o resultados.json] [-s tdas|films]\n"
+          "     %s -c base.json nuevo.json [-t umbral%%]\n",
+          programa, programa);
+  exit(EXIT_FAILURE);
+}
+
+int main(int argc, char *argv[]) {
+  int exp_max = EXP_POR_DEFECTO;
+  const char *ruta_json = NULL, *solo = NULL;
+  const char *comparar[2] = {NULL, NULL};
+  double umbral = UMBRAL_POR_DEFECTO;
+
+  int opcion;
+  while ((opcion = getopt(argc, argv, "n:r:o:s:c:t:")) != -1) {
+    switch (opcion) {
+    case 'n':
+      exp_max = atoi(optarg);
+      if (exp_max < 2 || exp_max > EXP_MAXIMO)
+        uso(argv[0]);
+      break;
+    case 'r':
+      ruta_origen = optarg;
+      break;
+    case 'o':
+      ruta_json = optarg;
+      break;
+    case 's':
+      solo = optarg;
+      break;
+    case 'c':
+      comparar[0] = optarg;
+      break;
+    case 't':
+      umbral = atof(optarg);
+      break;
+    default:
+      uso(argv[0]);
+    }
+  }
+
+  if (comparar[0] != NULL) {
+    if (optind != argc - 1)
+      uso(argv[0]);
+    comparar[1] = argv[optind];
+    return comparar_resultados(comparar[0], comparar[1], umbral) > 0
+               ? EXIT_FAILURE
+               : EXIT_SUCCESS;
+  }
+  if (optind != argc)
+    uso(argv[0]);
+
+  int medir_tdas = solo == NULL || strcmp(solo, "tdas") == 0;
+  int medir_peliculas = solo == NULL || strcmp(solo, "films") == 0;
+  if (!medir_tdas && !medir_peliculas)
+    uso(argv[0]);
+
+  printf("%-26s %10s %12s %10s %10s\n", "caso", "n", "ns/op", "allocs/op",
+         "rss (KB)");
+  if (medir_tdas)
+    for (size_t c = 0; c < sizeof(casos_tdas) / sizeof(Caso); c++)
+      for (long n = 100, e = 2; e <= exp_max; n *= 10, e++)
+        if (casos_tdas[c].n_max == 0 || n <= casos_tdas[c].n_max)
+          ejecutar_caso(casos_tdas[c].funcion, n);
+
+  if (medir_peliculas) {
+    if (mkdtemp(dir_temporal) == NULL) {
+      perror("Error al crear el directorio temporal");
+      return EXIT_FAILURE;
+    }
+    for (long n = 100, e = 2; e <= exp_max; n *= 10, e++) {
+      char ruta[256];
+      ruta_catalogo(ruta, sizeof(ruta), n);
+      ejecutar_caso(caso_escribir_catalogo, n);
+      for (size_t c = 0; c < sizeof(casos_peliculas) / sizeof(Caso); c++)
+        ejecutar_caso(casos_peliculas[c].funcion, n);
+      // Los catálogos grandes ocupan bastante disco; se borran al terminar
+      unlink(ruta);
+      ruta_instantanea(ruta, sizeof(ruta), n);
+      unlink(ruta);
+    }
+    rmdir(dir_temporal);
+  }
+
+  if (ruta_json != NULL)
+    guardar_resultados(ruta_json);
+  free(resultados);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,409 @@
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+// Genera catálogos de películas sintéticos con el mismo formato que los CSV de
+// IMDb de data/, de cualquier tamaño, para medir la carga y las consultas a
+// gran escala. Las distribuciones imitan las de data/Top1500.csv y la salida
+// depende solo de la semilla y del número de filas.
+
+#define CABECERA                                                               \
+  "Position,Const,Created,Modified,Description,Title,URL,Title Type,IMDb "     \
+  "Rating,Runtime (mins),Year,Genres,Num Votes,Release Date,Directors\n"
+
+// Tamaño del búfer de salida; se escribe al pasar de BUFER - MAX_FILA bytes
+#define BUFER (1 << 20)
+#define MAX_FILA 1024
+
+#define N_ELEMENTOS(a) ((int)(sizeof(a) / sizeof((a)[0])))
+
+/* ---------- Generador pseudoaleatorio ---------- */
+
+// Estado del generador (splitmix64): rápido y con la misma secuencia en
+// cualquier plataforma para una semilla dada
+static uint64_t estado;
+
+static uint64_t aleatorio() {
+  uint64_t z = (estado += 0x9e3779b97f4a7c15ULL);
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  return z ^ (z >> 31);
+}
+
+// Número uniforme en [0, 1)
+static double uniforme() { return (aleatorio() >> 11) * (1.0 / (1ULL << 53)); }
+
+// Entero uniforme en [0, n)
+static long entero(long n) { return (long)(uniforme() * n); }
+
+// Número con distribución normal (Box-Muller)
+static double normal(double media, double desviacion) {
+  double u = 1 - uniforme(), v = uniforme();
+  return media + desviacion * sqrt(-2 * log(u)) * cos(2 * M_PI * v);
+}
+
+/**
+ * Elige un índice en [0, n) según los pesos dados (no necesitan sumar 1).
+ */
+static int elegir(const double *pesos, int n) {
+  double total = 0;
+  for (int i = 0; i < n; i++)
+    total += pesos[i];
+  double x = uniforme() * total;
+  for (int i = 0; i < n - 1; i++) {
+    if (x < pesos[i])
+      return i;
+    x -= pesos[i];
+  }
+  return n - 1;
+}
+
+/**
+ * Elige un rango en [1, n] con distribución de Zipf de exponente s (s < 1),
+ * invirtiendo su aproximación continua: el rango 1 es el más frecuente y la
+ * frecuencia decae como 1 / k^s. Toma O(1) para cualquier n.
+ */
+static long zipf(long n, double s) {
+  double a = 1 - s;
+  double x = pow(1 + uniforme() * (pow(n + 1, a) - 1), 1 / a);
+  long k = (long)x;
+  return k < 1 ? 1 : k > n ? n : k;
+}
+
+/* ---------- Distribuciones de data/Top1500.csv ---------- */
+
+// Géneros y su número de apariciones
+static const char *generos[] = {
+    "Action",  "Adventure", "Animation", "Biography", "Comedy",  "Crime",
+    "Drama",   "Family",    "Fantasy",   "Film-Noir", "History", "Horror",
+    "Music",   "Musical",   "Mystery",   "Romance",   "Sci-Fi",  "Sport",
+    "Thriller", "War",      "Western"};
+static const double pesos_generos[] = {201, 228, 43,  131, 568, 341, 981,
+                                       106, 107, 60,  80,  23,  51,  85,
+                                       164, 428, 84,  55,  359, 94,  72};
+
+// Películas con 1, 2, ..., 7 géneros
+static const double pesos_n_generos[] = {171, 430, 503, 289, 83, 18, 6};
+
+// Películas por década desde 1910
+static const double pesos_decadas[] = {1,   25,  84,  135, 159, 174,
+                                       157, 184, 242, 273, 66};
+
+#define MEDIA_RATING 7.37
+#define DESVIACION_RATING 0.61
+#define MEDIA_LOG_VOTOS 11.09
+#define DESVIACION_LOG_VOTOS 1.67
+#define MEDIA_DURACION 115.6
+#define DESVIACION_DURACION 25.4
+
+// Hay unos 0,43 directores distintos por película, con pocos directores con
+// muchas películas (Zipf de exponente 0,6), y un 7,7% de las películas tiene
+// dos directores
+#define DIRECTORES_POR_PELICULA 0.43
+#define EXPONENTE_DIRECTORES 0.6
+#define PROB_CODIRECTOR 0.077
+
+// Un 2% de los títulos tiene una coma (van entre comillas) y un 0,5% tiene
+// comillas (se escapan como "")
+#define PROB_TITULO_COMA 0.02
+#define PROB_TITULO_COMILLAS 0.005
+
+/* ---------- Nombres ---------- */
+
+static const char *nombres[] = {
+    "Alfred",  "Martin", "Akira",   "Billy",   "Stanley", "Sofia",
+    "Ingmar",  "Agnes",  "Federico", "Kathryn", "Sidney",  "Jane",
+    "Yasujiro", "Greta", "Frank",   "Claire",  "Orson",   "Lina",
+    "Satyajit", "Chloe", "Werner",  "Ava",     "Sergio",  "Julie",
+    "Wong",    "Mira",   "Roman",   "Lucrecia", "Elia",    "Celine",
+    "Pedro",   "Andrea"};
+static const char *apellidos[] = {
+    "Hitchcock", "Scorsese", "Kurosawa", "Wilder",   "Kubrick", "Coppola",
+    "Bergman",   "Varda",    "Fellini",  "Bigelow",  "Lumet",   "Campion",
+    "Ozu",       "Gerwig",   "Capra",    "Denis",    "Welles",  "Wertmuller",
+    "Ray",       "Zhao",     "Herzog",   "DuVernay", "Leone",   "Dash",
+    "Kar-wai",   "Nair",     "Polanski", "Martel",   "Kazan",   "Sciamma",
+    "Almodovar", "Arnold",   "Tarkovsky", "Ozon",    "Lang",    "Reichardt",
+    "Ford",      "Chytilova", "Hawks",   "Akerman"};
+static const char *adjetivos[] = {
+    "Silent", "Last",   "Broken", "Golden", "Hidden", "Lost",  "Dark",
+    "Red",    "Eternal", "Little", "Wild",   "Quiet", "Seventh", "Great",
+    "Long",   "Distant", "Bitter", "Secret", "Empty", "Burning"};
+static const char *sustantivos[] = {
+    "River",   "City",   "Night",  "Road",   "Garden", "Storm",  "Mirror",
+    "Kingdom", "Window", "Harbor", "Train",  "Summer", "Bridge", "Voice",
+    "Island",  "Letter", "Dream",  "Shadow", "Empire", "Station", "Heart",
+    "Ghost",   "Winter", "Stranger"};
+static const char *numerales[] = {"II", "III", "IV"};
+
+/* ---------- Escritura ---------- */
+
+// Agrega un texto al búfer y retorna el nuevo final
+static char *agregar(char *p, const char *texto) {
+  while (*texto)
+    *p++ = *texto++;
+  return p;
+}
+
+// Agrega un entero no negativo con al menos `digitos` dígitos (con ceros)
+static char *agregar_entero(char *p, unsigned long x, int digitos) {
+  char tmp[24];
+  int n = 0;
+  do {
+    tmp[n++] = '0' + x % 10;
+    x /= 10;
+  } while (x > 0 || n < digitos);
+  while (n > 0)
+    *p++ = tmp[--n];
+  return p;
+}
+
+// Agrega una fecha AAAA-MM-DD
+static char *agregar_fecha(char *p, int anio, int mes, int dia) {
+  p = agregar_entero(p, anio, 4);
+  *p++ = '-';
+  p = agregar_entero(p, mes, 2);
+  *p++ = '-';
+  return agregar_entero(p, dia, 2);
+}
+
+/**
+ * Agrega el nombre del director de rango k (k >= 1). Los primeros nombres
+ * combinan un nombre y un apellido (repartidos para que los rangos cercanos no
+ * compartan apellido); luego se agrega una inicial y, pasadas todas las
+ * combinaciones, un número.
+ */
+static char *agregar_director(char *p, long k) {
+  long n = N_ELEMENTOS(nombres), a = N_ELEMENTOS(apellidos);
+  k--;
+  long apellido = k % a, vuelta = (k / a) % n, resto = k / (a * n);
+  // Como a + 1 y n son primos entre sí, cada vuelta usa nombres distintos
+  p = agregar(p, nombres[(vuelta * (a + 1) + apellido) % n]);
+  *p++ = ' ';
+  if (resto % 27 > 0) {
+    *p++ = 'A' + resto % 27 - 1;
+    p = agregar(p, ". ");
+  }
+  p = agregar(p, apellidos[apellido]);
+  if (resto / 27 > 0) {
+    *p++ = ' ';
+    p = agregar_entero(p, resto / 27 + 1, 1);
+  }
+  return p;
+}
+
+/**
+ * Agrega el título de una película, que se arma con palabras de las listas.
+ * Algunos títulos llevan coma o comillas para que el CSV tenga campos
+ * entrecomillados y comillas escapadas como el de IMDb.
+ */
+static char *agregar_titulo(char *p) {
+  const char *adj = adjetivos[entero(N_ELEMENTOS(adjetivos))];
+  const char *sus = sustantivos[entero(N_ELEMENTOS(sustantivos))];
+  double x = uniforme();
+  if (x < PROB_TITULO_COMA) {
+    *p++ = '"';
+    p = agregar(p, sus);
+    p = agregar(p, ", ");
+    p = agregar(p, adj);
+    *p++ = ' ';
+    p = agregar(p, sustantivos[entero(N_ELEMENTOS(sustantivos))]);
+    *p++ = '"';
+    return p;
+  }
+  if (x < PROB_TITULO_COMA + PROB_TITULO_COMILLAS) {
+    p = agregar(p, "\"The \"\"");
+    p = agregar(p, sus);
+    p = agregar(p, "\"\"\"");
+    return p;
+  }
+  switch (entero(4)) {
+  case 0:
+    p = agregar(p, "The ");
+    p = agregar(p, adj);
+    *p++ = ' ';
+    p = agregar(p, sus);
+    break;
+  case 1:
+    p = agregar(p, sus);
+    p = agregar(p, " of the ");
+    p = agregar(p, adj);
+    *p++ = ' ';
+    p = agregar(p, sustantivos[entero(N_ELEMENTOS(sustantivos))]);
+    break;
+  case 2:
+    p = agregar(p, adj);
+    *p++ = ' ';
+    p = agregar(p, sus);
+    break;
+  default:
+    p = agregar(p, apellidos[entero(N_ELEMENTOS(apellidos))]);
+    p = agregar(p, "'s ");
+    p = agregar(p, sus);
+  }
+  if (uniforme() < 0.05) {
+    *p++ = ' ';
+    p = agregar(p, numerales[entero(N_ELEMENTOS(numerales))]);
+  }
+  return p;
+}
+
+/**
+ * Agrega los géneros de una película en orden alfabético, separados por ", "
+ * y entre comillas si son más de uno, como en los CSV de IMDb.
+ */
+static char *agregar_generos(char *p) {
+  int n = elegir(pesos_n_generos, N_ELEMENTOS(pesos_n_generos)) + 1;
+  int elegido[N_ELEMENTOS(generos)] = {0};
+  for (int k = 0; k < n;) {
+    int g = elegir(pesos_generos, N_ELEMENTOS(generos));
+    if (!elegido[g]) {
+      elegido[g] = 1;
+      k++;
+    }
+  }
+  if (n > 1)
+    *p++ = '"';
+  for (int g = 0, k = 0; g < N_ELEMENTOS(generos); g++) {
+    if (!elegido[g])
+      continue;
+    if (k++ > 0)
+      p = agregar(p, ", ");
+    p = agregar(p, generos[g]);
+  }
+  if (n > 1)
+    *p++ = '"';
+  return p;
+}
+
+/**
+ * Escribe la fila de la película i (desde 0) de un catálogo con el número de
+ * directores dado. Retorna el final de la fila en el búfer.
+ */
+static char *escribir_fila(char *p, long i, long directores) {
+  char id[16];
+  *agregar_entero(id, i + 1, 7) = '\0';
+
+  p = agregar_entero(p, i + 1, 1);
+  p = agregar(p, ",tt");
+  p = agregar(p, id);
+  *p++ = ',';
+  int mes = 1 + entero(12), dia = 1 + entero(28);
+  p = agregar_fecha(p, 2013, mes, dia);
+  *p++ = ',';
+  p = agregar_fecha(p, 2013, mes, dia);
+  p = agregar(p, ", ,");
+  p = agregar_titulo(p);
+  p = agregar(p, ",https://www.imdb.com/title/tt");
+  p = agregar(p, id);
+  p = agregar(p, "/,movie,");
+
+  double rating = normal(MEDIA_RATING, DESVIACION_RATING);
+  int decimas = (int)lround(rating * 10);
+  decimas = decimas < 10 ? 10 : decimas > 100 ? 100 : decimas;
+  p = agregar_entero(p, decimas / 10, 1);
+  *p++ = '.';
+  p = agregar_entero(p, decimas % 10, 1);
+  *p++ = ',';
+
+  long duracion = lround(normal(MEDIA_DURACION, DESVIACION_DURACION));
+  p = agregar_entero(p, duracion < 45 ? 45 : duracion, 1);
+  *p++ = ',';
+
+  int decada = elegir(pesos_decadas, N_ELEMENTOS(pesos_decadas));
+  int anio = 1910 + 10 * decada + entero(10);
+  p = agregar_entero(p, anio, 4);
+  *p++ = ',';
+  p = agregar_generos(p);
+  *p++ = ',';
+
+  double votos = exp(normal(MEDIA_LOG_VOTOS, DESVIACION_LOG_VOTOS));
+  p = agregar_entero(p, votos < 1000 ? 1000 : (unsigned long)votos, 1);
+  *p++ = ',';
+  p = agregar_fecha(p, anio, 1 + entero(12), 1 + entero(28));
+  *p++ = ',';
+
+  long k = zipf(directores, EXPONENTE_DIRECTORES);
+  if (uniforme() < PROB_CODIRECTOR && directores > 1) {
+    long k2 = zipf(directores, EXPONENTE_DIRECTORES);
+    if (k2 == k)
+      k2 = k % directores + 1;
+    *p++ = '"';
+    p = agregar_director(p, k);
+    p = agregar(p, ", ");
+    p = agregar_director(p, k2);
+    *p++ = '"';
+  } else {
+    p = agregar_director(p, k);
+  }
+  *p++ = '\n';
+  return p;
+}
+
+static void uso(const char *programa) {
+  fprintf(stderr, "Uso: %s -n filas [-s semilla] [-o archivo.csv]\n",
+          programa);
+  exit(EXIT_FAILURE);
+}
+
+int main(int argc, char *argv[]) {
+  long filas = -1;
+  unsigned long long semilla = 1;
+  const char *ruta = NULL;
+
+  int opcion;
+  while ((opcion = getopt(argc, argv, "n:s:o:")) != -1) {
+    switch (opcion) {
+    case 'n':
+      filas = atol(optarg);
+      break;
+    case 's':
+      semilla = strtoull(optarg, NULL, 10);
+      break;
+    case 'o':
+      ruta = optarg;
+      break;
+    default:
+      uso(argv[0]);
+    }
+  }
+  if (filas < 0 || optind != argc)
+    uso(argv[0]);
+
+  FILE *salida = ruta ? fopen(ruta, "w") : stdout;
+  if (salida == NULL) {
+    perror("Error al crear el archivo");
+    return EXIT_FAILURE;
+  }
+
+  char *bufer = malloc(BUFER);
+  if (bufer == NULL) {
+    perror("Error al reservar memoria");
+    return EXIT_FAILURE;
+  }
+  estado = semilla;
+  long directores = (long)(filas * DIRECTORES_POR_PELICULA);
+  if (directores < 1)
+    directores = 1;
+
+  char *p = agregar(bufer, CABECERA);
+  for (long i = 0; i < filas; i++) {
+    p = escribir_fila(p, i, directores);
+    if (p - bufer > BUFER - MAX_FILA) {
+      if (fwrite(bufer, 1, p - bufer, salida) != (size_t)(p - bufer))
+        break;
+      p = bufer;
+    }
+  }
+  fwrite(bufer, 1, p - bufer, salida);
+  free(bufer);
+
+  if (ferror(salida) || (ruta && fclose(salida) != 0)) {
+    perror("Error al escribir el archivo");
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,1880 @@
+#include "filmdb.h"
+#include "tdas/arena.h"
+#include "tdas/extra.h"
+#include "tdas/map.h"
+#include "tdas/string_pool.h"
+#include "tdas/text_index.h"
+#include "tdas/trigram_index.h"
+#include <fcntl.h>
+#include <limits.h>
+#include <pthread.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+// Bytes mínimos de CSV por hilo al cargar en paralelo: para archivos más chicos
+// crear hilos cuesta más de lo que ahorra
+#define MIN_BYTES_POR_HILO (1 << 20)
+
+// Columnas de cada fila del CSV de IMDb (agregar_pelicula usa hasta la 14)
+#define COLUMNAS_CSV 15
+
+// Géneros distintos que caben en la máscara de bits de cada película (IMDb usa
+// menos de 30). Con 32 bits por película, SSE2/AVX2 revisan 4/8 películas por
+// instrucción al filtrar.
+#define MAX_GENEROS FILMDB_MAX_GENRES
+
+/**
+ * Tabla de películas guardada por columnas: la película i es la fila i de cada
+ * arreglo. Así un filtro por año o calificación recorre solo los arreglos que
+ * necesita, de forma contigua, sin traer a caché el resto de los datos.
+ *
+ * Los textos propios de cada película (id y título) se guardan como
+ * desplazamientos dentro de `textos`, un montículo de cadenas terminadas en
+ * '\0'. Al cargar desde el CSV el montículo es el propio archivo mapeado, así
+ * que esos textos no se copian. Los directores y géneros, que se repiten entre
+ * películas, se internan: se guardan una vez y cada fila guarda su id.
+ *
+ * Al cargar desde una instantánea, las columnas apuntan al archivo mapeado y
+ * capacidad es 0.
+ */
+typedef struct {
+  int total;          // número de filas (películas)
+  int capacidad;      // filas reservadas en cada columna
+  const char *textos; // montículo de cadenas
+  size_t *id;         // desplazamientos en textos
+  size_t *titulo;
+  int *director;      // id en el conjunto de directores
+  int *anio;
+  float *rating;
+  int *votos;
+  int *duracion;      // en minutos
+  uint32_t *generos;  // bit g encendido si la película tiene el género g
+
+  StringPool *directores;      // nombres de directores (id -> nombre)
+  StringPool *nombres_generos; // diccionario de géneros (bit -> nombre)
+} TablaPeliculas;
+
+// Lista de filas de la tabla (películas) que cumplen un criterio. Con
+// capacidad 0 el arreglo no es propio (apunta a una instantánea mapeada).
+typedef struct {
+  int *filas;
+  int total;
+  int capacidad;
+} ListaFilas;
+
+/**
+ * Compara dos claves de tipo string para determinar si son iguales.
+ * Esta función se utiliza para inicializar mapas con claves de tipo string.
+ *
+ * @param key1 Primer puntero a la clave string.
+ * @param key2 Segundo puntero a la clave string.
+ * @return Retorna 1 si las claves son iguales, 0 de lo contrario.
+ */
+static int is_equal_str(void *key1, void *key2) {
+  return strcmp((char *)key1, (char *)key2) == 0;
+}
+
+/**
+ * Calcula el hash de una clave de tipo string (FNV-1a).
+ * Esta función se utiliza junto a is_equal_str para crear mapas hash con claves
+ * de tipo string.
+ *
+ * @param key Puntero a la clave string.
+ * @return Retorna el valor hash de la clave.
+ */
+static unsigned long hash_str(void *key) {
+  unsigned long h = 14695981039346656037UL;
+  for (unsigned char *c = (unsigned char *)key; *c; c++) {
+    h ^= *c;
+    h *= 1099511628211UL;
+  }
+  return h;
+}
+
+/**
+ * Compara dos claves de tipo entero para determinar si la primera es menor.
+ * Esta función se utiliza para inicializar mapas ordenados con claves enteras.
+ *
+ * @param key1 Primer puntero a la clave entera.
+ * @param key2 Segundo puntero a la clave entera.
+ * @return Retorna 1 si key1 es menor que key2, 0 de lo contrario.
+ */
+static int lower_than_int(void *key1, void *key2) {
+  return *(int *)key1 < *(int *)key2;
+}
+
+/**
+ * Catálogo de películas: la tabla por columnas y un índice por criterio de
+ * búsqueda. Cada índice secundario asocia su clave a la lista de filas que la
+ * cumplen, de modo que una búsqueda solo recorre las películas que coinciden.
+ */
+struct FilmDB {
+  TablaPeliculas tabla;
+  Map *pelis_byid;       // id -> fila (guardada en el puntero del valor)
+  StringPool *directores_min;  // directores plegados (plegar_texto)
+  ListaFilas *pelis_bydirector; // id en directores_min -> filas
+  int cap_directores;           // capacidad de pelis_bydirector
+  int *director_min;            // id del director -> id en directores_min
+  int n_director_min;           // directores con su id plegado
+  int cap_director_min;         // capacidad de director_min
+  ListaFilas pelis_bygenero[MAX_GENEROS]; // bit del género -> filas
+  Map *pelis_bydecada;   // década (int) -> ListaFilas, ordenado
+  int *pelis_byrating;   // filas ordenadas por calificación
+  ArchivoCSV *csv;       // archivo que hace de montículo de textos
+  Arena *arena;          // pares de los mapas, claves y listas de los índices
+
+  // Solo al cargar desde una instantánea: el archivo mapeado y la tabla hash
+  // de ids que reemplaza a pelis_byid (filas, -1 en los slots vacíos)
+  char *instantanea;
+  size_t tam_instantanea;
+  const int *slots_byid;
+  int n_slots_byid; // potencia de 2
+
+  // Índice de títulos plegados para buscar por parte o comienzo del título.
+  // Se crea en la primera búsqueda por título (ver indice_titulos).
+  TextIndex *titulos;
+  int hilos; // hilos de la carga, que también ordenan el índice de títulos
+  int filas_omitidas; // filas del CSV con menos de COLUMNAS_CSV campos
+
+  // Índices de trigramas para las búsquedas aproximadas (FILMDB_FUZZY) de
+  // directores plegados (por id en directores_min) y de títulos plegados. Se
+  // crean en la primera búsqueda aproximada de cada uno.
+  TrigramIndex *trigramas_directores;
+  TrigramIndex *trigramas_titulos;
+};
+
+typedef struct FilmDB Catalogo;
+
+// Crea los mapas de un catálogo vacío. Los objetos pequeños de los índices se
+// reservan en la arena del catálogo y se liberan de una vez al final.
+static void inicializar_catalogo(Catalogo *cat) {
+  memset(cat, 0, sizeof(Catalogo));
+  cat->arena = arena_create();
+  cat->pelis_byid = hash_map_create(hash_str, is_equal_str);
+  map_set_arena(cat->pelis_byid, cat->arena);
+  cat->tabla.directores = strpool_create();
+  cat->tabla.nombres_generos = strpool_create();
+  cat->directores_min = strpool_create();
+  cat->pelis_bydecada = sorted_map_create(lower_than_int);
+  map_set_arena(cat->pelis_bydecada, cat->arena);
+}
+
+// Retorna el texto guardado en el desplazamiento `off` del montículo
+static const char *texto(TablaPeliculas *tabla, size_t off) {
+  return tabla->textos + off;
+}
+
+// Agranda un arreglo de columna a `capacidad` elementos de `tam` bytes
+static int crecer_columna(void **columna, size_t tam, int capacidad) {
+  void *nueva = realloc(*columna, capacidad * tam);
+  if (nueva == NULL)
+    return 0;
+  *columna = nueva;
+  return 1;
+}
+
+// Asegura espacio para `filas` filas en todas las columnas de la tabla
+static int reservar_filas(TablaPeliculas *tabla, int filas) {
+  if (filas <= tabla->capacidad)
+    return 1;
+  int capacidad = tabla->capacidad ? tabla->capacidad : 1024;
+  while (capacidad < filas)
+    capacidad *= 2;
+  if (!crecer_columna((void **)&tabla->id, sizeof(size_t), capacidad) ||
+      !crecer_columna((void **)&tabla->titulo, sizeof(size_t), capacidad) ||
+      !crecer_columna((void **)&tabla->director, sizeof(int), capacidad) ||
+      !crecer_columna((void **)&tabla->anio, sizeof(int), capacidad) ||
+      !crecer_columna((void **)&tabla->rating, sizeof(float), capacidad) ||
+      !crecer_columna((void **)&tabla->votos, sizeof(int), capacidad) ||
+      !crecer_columna((void **)&tabla->duracion, sizeof(int), capacidad) ||
+      !crecer_columna((void **)&tabla->generos, sizeof(uint32_t), capacidad))
+    return 0;
+  tabla->capacidad = capacidad;
+  return 1;
+}
+
+/**
+ * Retorna el bit asociado a un género en el diccionario de la tabla. Si el
+ * género no existe y `crear` es 1 se le asigna el siguiente bit libre.
+ *
+ * @return Retorna el bit del género, o -1 si no existe (o no quedan bits).
+ */
+static int bit_genero(TablaPeliculas *tabla, const char *nombre, int crear) {
+  int g = strpool_find(tabla->nombres_generos, nombre);
+  if (g != -1 || !crear ||
+      strpool_size(tabla->nombres_generos) == MAX_GENEROS)
+    return g;
+  return strpool_intern(tabla->nombres_generos, nombre);
+}
+
+// Retorna el nombre del director de una fila
+static const char *nombre_director(TablaPeliculas *tabla, int fila) {
+  return strpool_get(tabla->directores, tabla->director[fila]);
+}
+
+// Agrega una fila al final de una lista de filas
+static int agregar_fila(ListaFilas *lista, int fila) {
+  if (lista->total == lista->capacidad) {
+    int capacidad = lista->capacidad ? lista->capacidad * 2 : 8;
+    if (!crecer_columna((void **)&lista->filas, sizeof(int), capacidad))
+      return 0;
+    lista->capacidad = capacidad;
+  }
+  lista->filas[lista->total++] = fila;
+  return 1;
+}
+
+// Libera el arreglo de una lista de filas, si es propio
+static void liberar_filas(ListaFilas *lista) {
+  if (lista->capacidad > 0)
+    free(lista->filas);
+}
+
+// Agranda un arreglo de listas de filas para que tenga al menos n listas
+static int reservar_listas(ListaFilas **listas, int *capacidad, int n) {
+  if (n <= *capacidad)
+    return 1;
+  int cap = *capacidad ? *capacidad : 256;
+  while (cap < n)
+    cap *= 2;
+  if (!crecer_columna((void **)listas, sizeof(ListaFilas), cap))
+    return 0;
+  memset(*listas + *capacidad, 0, (cap - *capacidad) * sizeof(ListaFilas));
+  *capacidad = cap;
+  return 1;
+}
+
+/**
+ * Agrega una fila a la lista asociada a `clave` en un índice secundario,
+ * creando la lista si la clave no existía. La clave se copia (tam bytes) a la
+ * arena solo cuando se agrega al índice por primera vez.
+ */
+static int agregar_a_indice(Arena *arena, Map *indice, void *clave, size_t tam,
+                            int fila) {
+  MapPair *pair = map_search(indice, clave);
+  if (pair == NULL) {
+    void *copia = arena_alloc(arena, tam);
+    ListaFilas *filas = (ListaFilas *)arena_alloc(arena, sizeof(ListaFilas));
+    if (copia == NULL || filas == NULL)
+      return 0;
+    memcpy(copia, clave, tam);
+    memset(filas, 0, sizeof(ListaFilas));
+    map_insert(indice, copia, filas);
+    return agregar_fila(filas, fila);
+  }
+  return agregar_fila(pair->value, fila);
+}
+
+/**
+ * Asocia un director recién internado (id d, igual a n_director_min) con su
+ * nombre plegado, internándolo en directores_min.
+ */
+static int asociar_director_min(Catalogo *cat, int d, const char *min) {
+  if (d < cat->n_director_min)
+    return 1; // Ya estaba asociado
+  if (d == cat->cap_director_min) {
+    int cap = cat->cap_director_min ? cat->cap_director_min * 2 : 256;
+    if (!crecer_columna((void **)&cat->director_min, sizeof(int), cap))
+      return 0;
+    cat->cap_director_min = cap;
+  }
+  int dm = strpool_intern(cat->directores_min, min);
+  cat->director_min[cat->n_director_min++] = dm;
+  return dm != -1;
+}
+
+/**
+ * Crea una película a partir de los campos de una línea del CSV: la agrega
+ * como nueva fila de la tabla, al mapa por ID y a los índices secundarios.
+ */
+static int agregar_pelicula(Catalogo *cat, CampoCSV *campos) {
+  TablaPeliculas *tabla = &cat->tabla;
+  int fila = tabla->total;
+  if (!reservar_filas(tabla, fila + 1))
+    return 0;
+
+  // Los textos quedan como desplazamientos dentro del archivo mapeado
+  tabla->id[fila] = campos[1].ptr - tabla->textos;        // Asigna ID
+  tabla->titulo[fila] = campos[5].ptr - tabla->textos;    // Asigna título
+  int d = strpool_intern(tabla->directores, campos[14].ptr); // Asigna director
+  if (d == -1)
+    return 0;
+  tabla->director[fila] = d;
+  tabla->rating[fila] = atof(campos[8].ptr);   // Asigna calificación
+  tabla->duracion[fila] = atoi(campos[9].ptr); // Asigna duración
+  tabla->anio[fila] = atoi(campos[10].ptr);    // Asigna año
+  tabla->votos[fila] = atoi(campos[12].ptr);   // Asigna número de votos
+
+  // Divide los géneros separados por comas (en el mismo lugar), les asigna un
+  // bit en la máscara de la película y la indexa por cada uno de ellos
+  uint32_t mascara = 0;
+  char *resto;
+  char *token = strtok_r(campos[11].ptr, ",", &resto);
+  while (token != NULL) {
+    // Elimina los espacios al principio de cada género
+    while (*token == ' ')
+      token++;
+    int g = bit_genero(tabla, token, 1);
+    if (g != -1 && !(mascara & (1u << g))) {
+      mascara |= 1u << g;
+      if (!agregar_fila(&cat->pelis_bygenero[g], fila))
+        return 0;
+    }
+    token = strtok_r(NULL, ",", &resto);
+  }
+  tabla->generos[fila] = mascara;
+
+  // Inserta la película en el mapa usando el ID como clave
+  map_insert(cat->pelis_byid, campos[1].ptr, (void *)(intptr_t)fila);
+
+  // Indexa la película por director plegado (en minúsculas y sin acentos, ver
+  // plegar_texto). La forma plegada se calcula solo la primera vez que aparece
+  // cada director; las consultas la buscan con una sola búsqueda en el hash de
+  // directores_min y recorren la lista de películas de ese director.
+  if (d == cat->n_director_min) { // Director nuevo (los ids son correlativos)
+    char *director = strdup(campos[14].ptr);
+    if (director == NULL)
+      return 0;
+    plegar_texto(director);
+    int ok = asociar_director_min(cat, d, director);
+    free(director);
+    if (!ok)
+      return 0;
+  }
+  int dm = cat->director_min[d];
+  if (dm == -1 ||
+      !reservar_listas(&cat->pelis_bydirector, &cat->cap_directores, dm + 1) ||
+      !agregar_fila(&cat->pelis_bydirector[dm], fila))
+    return 0;
+
+  // Indexa la película por década
+
+  int decada = tabla->anio[fila] - (tabla->anio[fila] % 10);
+  if (!agregar_a_indice(cat->arena, cat->pelis_bydecada, &decada,
+                        sizeof(int), fila))
+    return 0;
+
+  tabla->total++;
+  return 1;
+}
+
+// Par (calificación, fila) para ordenar las filas por calificación
+typedef struct {
+  float rating;
+  int fila;
+} RatingFila;
+
+// Compara por calificación y, a igual calificación, por fila
+static int comparar_rating(const void *a, const void *b) {
+  const RatingFila *r1 = a, *r2 = b;
+  if (r1->rating != r2->rating)
+    return r1->rating < r2->rating ? -1 : 1;
+  return (r1->fila > r2->fila) - (r1->fila < r2->fila);
+}
+
+// Construye el arreglo de filas ordenadas por calificación
+static int ordenar_por_rating(Catalogo *cat) {
+  int total = cat->tabla.total;
+  RatingFila *pares = (RatingFila *)malloc(total * sizeof(RatingFila) + 1);
+  cat->pelis_byrating = (int *)malloc(total * sizeof(int) + 1);
+  if (pares == NULL || cat->pelis_byrating == NULL) {
+    free(pares);
+    return 0;
+  }
+  for (int i = 0; i < total; i++) {
+    pares[i].rating = cat->tabla.rating[i];
+    pares[i].fila = i;
+  }
+  qsort(pares, total, sizeof(RatingFila), comparar_rating);
+  for (int i = 0; i < total; i++)
+    cat->pelis_byrating[i] = pares[i].fila;
+  free(pares);
+  return 1;
+}
+
+// Tramo del CSV que carga un hilo en un catálogo parcial
+typedef struct {
+  ArchivoCSV *csv;
+  Catalogo parcial;
+  int omitidas; // filas con menos de COLUMNAS_CSV campos
+  int error;
+  int en_hilo; // 1 si lo carga un hilo propio
+} TramoCarga;
+
+// Función de cada hilo: carga las películas de su tramo en su catálogo parcial
+static void *cargar_tramo(void *arg) {
+  TramoCarga *tramo = arg;
+  CampoCSV campos[COLUMNAS_CSV];
+  // Separa una línea del archivo CSV en campos. Cada campo es una vista
+  // (puntero, largo) terminada en '\0' dentro del archivo mapeado, de modo que
+  // las películas apuntan a sus textos sin copiarlos. Las filas incompletas se
+  // omiten: sus campos faltantes no se llenarían.
+  int n;
+  while ((n = csv_leer_linea(tramo->csv, ',', campos, COLUMNAS_CSV)) != -1) {
+    if (n < COLUMNAS_CSV) {
+      tramo->omitidas++;
+      continue;
+    }
+    if (!agregar_pelicula(&tramo->parcial, campos)) {
+      tramo->error = 1;
+      break;
+    }
+  }
+  return NULL;
+}
+
+/**
+ * Traspasa las listas de un índice parcial al índice global, sumando `base` a
+ * cada fila. Las listas de una misma clave se concatenan, así que al fusionar
+ * los tramos en orden cada lista queda en el orden del archivo. El índice
+ * parcial queda vacío y se libera; sus claves y listas siguen en la arena del
+ * catálogo parcial, que luego se traspasa a la del global.
+ *
+ * @return Retorna 0 si falla la asignación de memoria.
+ */
+static int fusionar_indice(Map *global, Map *parcial, int base) {
+  int ok = 1;
+  MapIter it;
+  for (MapPair *pair = map_iter_first(parcial, &it); pair != NULL;
+       pair = map_iter_next(&it)) {
+    ListaFilas *filas = pair->value;
+    for (int i = 0; i < filas->total; i++)
+      filas->filas[i] += base;
+
+    MapPair *existente = map_search(global, pair->key);
+    if (existente == NULL) {
+      map_insert(global, pair->key, filas);
+      continue;
+    }
+    for (int i = 0; ok && i < filas->total; i++)
+      ok = agregar_fila(existente->value, filas->filas[i]);
+    free(filas->filas);
+  }
+  map_clean(parcial);
+  free(parcial);
+  return ok;
+}
+
+// Libera los conjuntos de cadenas y listas de un catálogo parcial ya fusionado
+static void liberar_parcial(Catalogo *parcial) {
+  TablaPeliculas *tp = &parcial->tabla;
+  free(tp->id);
+  free(tp->titulo);
+  free(tp->director);
+  free(tp->anio);
+  free(tp->rating);
+  free(tp->votos);
+  free(tp->duracion);
+  free(tp->generos);
+  strpool_clean(tp->directores);
+  free(tp->directores);
+  strpool_clean(tp->nombres_generos);
+  free(tp->nombres_generos);
+  for (int dm = 0; dm < strpool_size(parcial->directores_min); dm++)
+    free(parcial->pelis_bydirector[dm].filas);
+  free(parcial->pelis_bydirector);
+  free(parcial->director_min);
+  strpool_clean(parcial->directores_min);
+  free(parcial->directores_min);
+  for (int g = 0; g < MAX_GENEROS; g++)
+    free(parcial->pelis_bygenero[g].filas);
+}
+
+/**
+ * Libera la memoria de un índice secundario: los arreglos de filas. Las claves
+ * y las listas están en la arena del catálogo.
+ */
+static void liberar_indice(Map *indice) {
+  MapIter it;
+  for (MapPair *pair = map_iter_first(indice, &it); pair != NULL;
+       pair = map_iter_next(&it)) {
+    liberar_filas(pair->value);
+  }
+  map_clean(indice);
+  free(indice);
+}
+
+// Libera la tabla, los índices y el archivo del catálogo
+static void liberar_catalogo(Catalogo *cat) {
+  // Si falló una carga, puede haber directores plegados sin lista
+  for (int dm = 0;
+       dm < strpool_size(cat->directores_min) && dm < cat->cap_directores; dm++)
+    liberar_filas(&cat->pelis_bydirector[dm]);
+  free(cat->pelis_bydirector);
+  strpool_clean(cat->directores_min);
+  free(cat->directores_min);
+  liberar_indice(cat->pelis_bydecada);
+  for (int g = 0; g < MAX_GENEROS; g++)
+    liberar_filas(&cat->pelis_bygenero[g]);
+  map_clean(cat->pelis_byid); // Las claves apuntan al archivo
+  free(cat->pelis_byid);
+
+  TablaPeliculas *tabla = &cat->tabla;
+  if (cat->instantanea != NULL) {
+    // Las columnas y arreglos de los índices están en el archivo mapeado
+    munmap(cat->instantanea, cat->tam_instantanea);
+  } else {
+    free(cat->director_min);
+    free(cat->pelis_byrating);
+    free(tabla->id);
+    free(tabla->titulo);
+    free(tabla->director);
+    free(tabla->anio);
+    free(tabla->rating);
+    free(tabla->votos);
+    free(tabla->duracion);
+    free(tabla->generos);
+  }
+  strpool_clean(tabla->directores);
+  free(tabla->directores);
+  strpool_clean(tabla->nombres_generos);
+  free(tabla->nombres_generos);
+  arena_clean(cat->arena); // Pares, claves y listas de los índices
+  free(cat->arena);
+  csv_cerrar(cat->csv); // Libera el archivo al que apuntaban los textos
+  if (cat->titulos != NULL) {
+    textindex_clean(cat->titulos);
+    free(cat->titulos);
+  }
+  if (cat->trigramas_directores != NULL) {
+    trigram_clean(cat->trigramas_directores);
+    free(cat->trigramas_directores);
+  }
+  if (cat->trigramas_titulos != NULL) {
+    trigram_clean(cat->trigramas_titulos);
+    free(cat->trigramas_titulos);
+  }
+}
+
+// Deja el catálogo vacío, como recién creado, liberando lo que tenía. Se
+// conserva el número de hilos de la carga.
+static void reiniciar_catalogo(Catalogo *cat) {
+  int hilos = cat->hilos;
+  liberar_catalogo(cat);
+  inicializar_catalogo(cat);
+  cat->hilos = hilos;
+}
+
+/**
+ * Traspasa las filas e índices de un catálogo parcial al catálogo global. Los
+ * ids de directores y los bits de géneros del parcial se traducen a los de los
+ * conjuntos globales.
+ */
+static int fusionar_catalogo(Catalogo *cat, Catalogo *parcial) {
+  TablaPeliculas *tabla = &cat->tabla, *tp = &parcial->tabla;
+  int base = tabla->total;
+  int ok = reservar_filas(tabla, base + tp->total);
+
+  int bit_global[MAX_GENEROS];
+  for (int g = 0; g < strpool_size(tp->nombres_generos); g++)
+    bit_global[g] =
+        bit_genero(tabla, strpool_get(tp->nombres_generos, g), 1);
+
+  int n_dir = strpool_size(tp->directores);
+  int *dir_global = (int *)malloc(n_dir * sizeof(int) + 1);
+  ok = ok && dir_global != NULL;
+  for (int d = 0; ok && d < n_dir; d++) {
+    dir_global[d] = strpool_intern(tabla->directores,
+                                   strpool_get(tp->directores, d));
+    const char *min =
+        strpool_get(parcial->directores_min, parcial->director_min[d]);
+    ok = dir_global[d] != -1 && asociar_director_min(cat, dir_global[d], min);
+  }
+
+  if (ok) {
+    memcpy(tabla->id + base, tp->id, tp->total * sizeof(size_t));
+    memcpy(tabla->titulo + base, tp->titulo, tp->total * sizeof(size_t));
+    memcpy(tabla->anio + base, tp->anio, tp->total * sizeof(int));
+    memcpy(tabla->rating + base, tp->rating, tp->total * sizeof(float));
+    memcpy(tabla->votos + base, tp->votos, tp->total * sizeof(int));
+    memcpy(tabla->duracion + base, tp->duracion, tp->total * sizeof(int));
+    for (int i = 0; i < tp->total; i++) {
+      tabla->director[base + i] = dir_global[tp->director[i]];
+      uint32_t mascara = 0;
+      for (int g = 0; g < strpool_size(tp->nombres_generos); g++)
+        if ((tp->generos[i] >> g & 1) && bit_global[g] != -1)
+          mascara |= 1u << bit_global[g];
+      tabla->generos[base + i] = mascara;
+    }
+    tabla->total += tp->total;
+
+    // Listas de directores: se concatenan en el orden de los tramos
+    for (int pm = 0; ok && pm < strpool_size(parcial->directores_min); pm++) {
+      int dm = strpool_find(cat->directores_min,
+                            strpool_get(parcial->directores_min, pm));
+      ListaFilas *filas = &parcial->pelis_bydirector[pm];
+      ok = reservar_listas(&cat->pelis_bydirector, &cat->cap_directores,
+                           dm + 1);
+      for (int i = 0; ok && i < filas->total; i++)
+        ok = agregar_fila(&cat->pelis_bydirector[dm], filas->filas[i] + base);
+    }
+    for (int g = 0; g < strpool_size(tp->nombres_generos); g++) {
+      ListaFilas *filas = &parcial->pelis_bygenero[g];
+      if (bit_global[g] != -1)
+        for (int i = 0; ok && i < filas->total; i++)
+          ok = agregar_fila(&cat->pelis_bygenero[bit_global[g]],
+                            filas->filas[i] + base);
+    }
+  }
+  free(dir_global);
+
+  MapIter it;
+  for (MapPair *pair = map_iter_first(parcial->pelis_byid, &it); pair != NULL;
+       pair = map_iter_next(&it))
+    map_insert(cat->pelis_byid, pair->key,
+               (void *)((intptr_t)pair->value + base));
+  map_clean(parcial->pelis_byid);
+  free(parcial->pelis_byid);
+  if (!fusionar_indice(cat->pelis_bydecada, parcial->pelis_bydecada, base))
+    ok = 0;
+  arena_absorb(cat->arena, parcial->arena);
+  free(parcial->arena);
+
+  liberar_parcial(parcial);
+  return ok;
+}
+
+/* ---------- Instantánea binaria del catálogo ---------- */
+
+// Formato de la instantánea: una cabecera seguida de secciones alineadas a 8
+// bytes. Cada sección se ubica por su desplazamiento desde el inicio del
+// archivo, así el archivo se mapea en memoria y se usa tal cual, sin parsear
+// ni copiar: las columnas, listas de filas y tablas apuntan dentro del mapeo.
+#define INSTANTANEA_MAGIA "PELISNAP"
+#define INSTANTANEA_VERSION 3
+#define INSTANTANEA_ORDEN 0x01020304u // Detecta otro orden de bytes
+
+// Secciones de la instantánea. Las listas de filas se guardan como un arreglo
+// de inicios (int64_t, n + 1) seguido de la sección con todas las filas.
+enum {
+  SEC_TEXTOS,          // cadenas terminadas en '\0'
+  SEC_ID,              // size_t por fila, desplazamiento en SEC_TEXTOS
+  SEC_TITULO,          // size_t por fila
+  SEC_DIRECTOR,        // int por fila
+  SEC_ANIO,            // int por fila
+  SEC_RATING,          // float por fila
+  SEC_VOTOS,           // int por fila
+  SEC_DURACION,        // int por fila
+  SEC_GENEROS,         // uint32_t por fila
+  SEC_BYRATING,        // int por fila
+  SEC_DIRECTORES,      // size_t por director
+  SEC_NOMBRES_GENEROS, // size_t por género
+  SEC_DIRECTORES_MIN,  // size_t por director plegado
+  SEC_DIRECTOR_MIN,    // int por director
+  SEC_BYDIR_INICIO,
+  SEC_BYDIR_FILAS,
+  SEC_BYGEN_INICIO,
+  SEC_BYGEN_FILAS,
+  SEC_DECADAS,         // int por década, en orden creciente
+  SEC_BYDEC_INICIO,
+  SEC_BYDEC_FILAS,
+  SEC_BYID,            // int por slot de la tabla hash de ids
+  N_SECCIONES
+};
+
+// Firma de un archivo: si cambia, la instantánea construida desde él ya no
+// sirve. El hash del contenido solo se calcula cuando hace falta.
+typedef struct {
+  uint64_t tamano;
+  int64_t mtime_s, mtime_ns;
+  uint64_t hash;
+  int con_hash;
+} FirmaArchivo;
+
+typedef struct {
+  char magia[8];
+  uint32_t version;
+  uint32_t orden;
+  uint32_t tam_size_t; // sizeof(size_t) del programa que la escribió
+  int32_t total;
+  int32_t n_directores, n_generos, n_directores_min, n_decadas;
+  int32_t n_slots_byid;
+  int32_t filas_omitidas;
+  uint64_t csv_tamano;
+  int64_t csv_mtime_s, csv_mtime_ns;
+  uint64_t csv_hash;
+  uint64_t hash_cuerpo; // hash_bytes de todo lo que sigue a la cabecera
+  uint64_t seccion[N_SECCIONES][2]; // desplazamiento y tamaño en bytes
+} CabeceraInstantanea;
+
+// Hash del contenido de un archivo: FNV-1a de a 8 bytes, mezclando los bits
+// altos hacia abajo en cada paso
+static uint64_t hash_bytes(const char *datos, size_t n) {
+  uint64_t h = 14695981039346656037ULL;
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    uint64_t w;
+    memcpy(&w, datos + i, 8);
+    h = (h ^ w) * 1099511628211ULL;
+    h ^= h >> 29;
+  }
+  for (; i < n; i++)
+    h = (h ^ (unsigned char)datos[i]) * 1099511628211ULL;
+  return h;
+}
+
+// Obtiene el tamaño y la fecha de modificación de un archivo
+static int firma_archivo(const char *ruta, FirmaArchivo *firma) {
+  struct stat st;
+  if (stat(ruta, &st) == -1)
+    return 0;
+  firma->tamano = st.st_size;
+  firma->mtime_s = st.st_mtim.tv_sec;
+  firma->mtime_ns = st.st_mtim.tv_nsec;
+  firma->con_hash = 0;
+  return 1;
+}
+
+// Calcula el hash del contenido de un archivo, mapeándolo en memoria
+static int hash_archivo(const char *ruta, FirmaArchivo *firma) {
+  if (firma->con_hash)
+    return 1;
+  int fd = open(ruta, O_RDONLY);
+  if (fd == -1)
+    return 0;
+  struct stat st;
+  if (fstat(fd, &st) == -1) {
+    close(fd);
+    return 0;
+  }
+  char *datos = NULL;
+  if (st.st_size > 0) {
+    datos = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (datos == MAP_FAILED) {
+      close(fd);
+      return 0;
+    }
+  }
+  close(fd);
+  firma->hash = hash_bytes(datos, st.st_size);
+  firma->con_hash = 1;
+  if (datos != NULL)
+    munmap(datos, st.st_size);
+  return 1;
+}
+
+// Escribe secciones de la instantánea llevando la cuenta de la posición
+typedef struct {
+  FILE *f;
+  uint64_t pos;
+  int error;
+  CabeceraInstantanea *cab;
+} EscritorInstantanea;
+
+static void escribir(EscritorInstantanea *e, const void *datos, size_t n) {
+  if (n > 0 && fwrite(datos, 1, n, e->f) != n)
+    e->error = 1;
+  e->pos += n;
+}
+
+// Alinea la posición a 8 bytes y marca el inicio de una sección
+static void abrir_seccion(EscritorInstantanea *e, int sec) {
+  static const char ceros[8];
+  escribir(e, ceros, (8 - e->pos % 8) % 8);
+  e->cab->seccion[sec][0] = e->pos;
+}
+
+static void cerrar_seccion(EscritorInstantanea *e, int sec) {
+  e->cab->seccion[sec][1] = e->pos - e->cab->seccion[sec][0];
+}
+
+static void escribir_seccion(EscritorInstantanea *e, int sec, const void *datos,
+                             size_t n) {
+  abrir_seccion(e, sec);
+  escribir(e, datos, n);
+  cerrar_seccion(e, sec);
+}
+
+// Agrega una cadena a SEC_TEXTOS y retorna su desplazamiento en la sección
+static size_t escribir_texto(EscritorInstantanea *e, const char *str) {
+  size_t off = e->pos - e->cab->seccion[SEC_TEXTOS][0];
+  escribir(e, str, strlen(str) + 1);
+  return off;
+}
+
+// Escribe n listas de filas en las secciones sec (inicios) y sec + 1 (filas)
+static void escribir_listas(EscritorInstantanea *e, int sec, ListaFilas *listas,
+                            int n) {
+  int64_t inicio = 0;
+  abrir_seccion(e, sec);
+  for (int i = 0; i < n; i++) {
+    escribir(e, &inicio, sizeof(int64_t));
+    inicio += listas[i].total;
+  }
+  escribir(e, &inicio, sizeof(int64_t));
+  cerrar_seccion(e, sec);
+  abrir_seccion(e, sec + 1);
+  for (int i = 0; i < n; i++)
+    escribir(e, listas[i].filas, listas[i].total * sizeof(int));
+  cerrar_seccion(e, sec + 1);
+}
+
+// Calcula el hash de lo escrito en la instantánea después de la cabecera
+// (`tam` bytes en total), mapeando el archivo
+static int hash_cuerpo(FILE *f, uint64_t tam, uint64_t *hash) {
+  if (fflush(f) != 0)
+    return 0;
+  char *datos = mmap(NULL, tam, PROT_READ, MAP_SHARED, fileno(f), 0);
+  if (datos == MAP_FAILED)
+    return 0;
+  *hash = hash_bytes(datos + sizeof(CabeceraInstantanea),
+                     tam - sizeof(CabeceraInstantanea));
+  munmap(datos, tam);
+  return 1;
+}
+
+/**
+ * Guarda el catálogo recién cargado desde el CSV en una instantánea. Se
+ * escribe en un archivo temporal que luego reemplaza al anterior, así una
+ * escritura interrumpida nunca deja una instantánea a medias.
+ *
+ * @param firma Firma del CSV (con hash) tomada antes de cargarlo.
+ * @return Retorna 1 si se guardó, 0 de lo contrario.
+ */
+static int guardar_instantanea(Catalogo *cat, const char *ruta,
+                               const FirmaArchivo *firma) {
+  TablaPeliculas *tabla = &cat->tabla;
+  int total = tabla->total;
+  int n_dir = strpool_size(tabla->directores);
+  int n_gen = strpool_size(tabla->nombres_generos);
+  int n_min = strpool_size(cat->directores_min);
+
+  char temporal[PATH_MAX];
+  if (snprintf(temporal, sizeof(temporal), "%s.tmp", ruta) >=
+      (int)sizeof(temporal))
+    return 0; // La ruta no cabe: no se guarda la instantánea
+  FILE *f = fopen(temporal, "w+b"); // También se lee, para el hash
+  if (f == NULL)
+    return 0;
+
+  CabeceraInstantanea cab;
+  memset(&cab, 0, sizeof(cab));
+  memcpy(cab.magia, INSTANTANEA_MAGIA, sizeof(cab.magia));
+  cab.version = INSTANTANEA_VERSION;
+  cab.orden = INSTANTANEA_ORDEN;
+  cab.tam_size_t = sizeof(size_t);
+  cab.total = total;
+  cab.n_directores = n_dir;
+  cab.n_generos = n_gen;
+  cab.n_directores_min = n_min;
+  cab.filas_omitidas = cat->filas_omitidas;
+  cab.csv_tamano = firma->tamano;
+  cab.csv_mtime_s = firma->mtime_s;
+  cab.csv_mtime_ns = firma->mtime_ns;
+  cab.csv_hash = firma->hash;
+
+  EscritorInstantanea e = {f, 0, 0, &cab};
+  escribir(&e, &cab, sizeof(cab)); // Se reescribe al final
+
+  // Textos: id y título de cada fila y los conjuntos de cadenas
+  size_t *id = (size_t *)malloc(total * sizeof(size_t) + 1);
+  size_t *titulo = (size_t *)malloc(total * sizeof(size_t) + 1);
+  size_t *cadenas = (size_t *)malloc((n_dir + n_gen + n_min) * sizeof(size_t) + 1);
+  int *decadas = NULL, *slots = NULL;
+  ListaFilas *listas_decada = NULL;
+  if (id == NULL || titulo == NULL || cadenas == NULL) {
+    e.error = 1;
+    goto fin;
+  }
+  abrir_seccion(&e, SEC_TEXTOS);
+  for (int f = 0; f < total; f++) {
+    id[f] = escribir_texto(&e, texto(tabla, tabla->id[f]));
+    titulo[f] = escribir_texto(&e, texto(tabla, tabla->titulo[f]));
+  }
+  for (int d = 0; d < n_dir; d++)
+    cadenas[d] = escribir_texto(&e, strpool_get(tabla->directores, d));
+  for (int g = 0; g < n_gen; g++)
+    cadenas[n_dir + g] =
+        escribir_texto(&e, strpool_get(tabla->nombres_generos, g));
+  for (int dm = 0; dm < n_min; dm++)
+    cadenas[n_dir + n_gen + dm] =
+        escribir_texto(&e, strpool_get(cat->directores_min, dm));
+  cerrar_seccion(&e, SEC_TEXTOS);
+
+  // Columnas
+  escribir_seccion(&e, SEC_ID, id, total * sizeof(size_t));
+  escribir_seccion(&e, SEC_TITULO, titulo, total * sizeof(size_t));
+  escribir_seccion(&e, SEC_DIRECTOR, tabla->director, total * sizeof(int));
+  escribir_seccion(&e, SEC_ANIO, tabla->anio, total * sizeof(int));
+  escribir_seccion(&e, SEC_RATING, tabla->rating, total * sizeof(float));
+  escribir_seccion(&e, SEC_VOTOS, tabla->votos, total * sizeof(int));
+  escribir_seccion(&e, SEC_DURACION, tabla->duracion, total * sizeof(int));
+  escribir_seccion(&e, SEC_GENEROS, tabla->generos, total * sizeof(uint32_t));
+  escribir_seccion(&e, SEC_BYRATING, cat->pelis_byrating, total * sizeof(int));
+
+  // Conjuntos de cadenas e índices
+  escribir_seccion(&e, SEC_DIRECTORES, cadenas, n_dir * sizeof(size_t));
+  escribir_seccion(&e, SEC_NOMBRES_GENEROS, cadenas + n_dir,
+                   n_gen * sizeof(size_t));
+  escribir_seccion(&e, SEC_DIRECTORES_MIN, cadenas + n_dir + n_gen,
+                   n_min * sizeof(size_t));
+  escribir_seccion(&e, SEC_DIRECTOR_MIN, cat->director_min,
+                   n_dir * sizeof(int));
+  escribir_listas(&e, SEC_BYDIR_INICIO, cat->pelis_bydirector, n_min);
+  escribir_listas(&e, SEC_BYGEN_INICIO, cat->pelis_bygenero, n_gen);
+
+  MapIter it;
+  for (MapPair *pair = map_iter_first(cat->pelis_bydecada, &it); pair != NULL;
+       pair = map_iter_next(&it))
+    cab.n_decadas++;
+  decadas = (int *)malloc(cab.n_decadas * sizeof(int) + 1);
+  listas_decada = (ListaFilas *)malloc(cab.n_decadas * sizeof(ListaFilas) + 1);
+  if (decadas == NULL || listas_decada == NULL) {
+    e.error = 1;
+    goto fin;
+  }
+  int i = 0;
+  for (MapPair *pair = map_iter_first(cat->pelis_bydecada, &it); pair != NULL;
+       pair = map_iter_next(&it), i++) {
+    decadas[i] = *(int *)pair->key;
+    listas_decada[i] = *(ListaFilas *)pair->value;
+  }
+  escribir_seccion(&e, SEC_DECADAS, decadas, cab.n_decadas * sizeof(int));
+  escribir_listas(&e, SEC_BYDEC_INICIO, listas_decada, cab.n_decadas);
+
+  // Tabla hash de ids con sondeo lineal y factor de carga <= 0.5
+  cab.n_slots_byid = 16;
+  while (cab.n_slots_byid < total * 2)
+    cab.n_slots_byid *= 2;
+  slots = (int *)malloc(cab.n_slots_byid * sizeof(int));
+  if (slots == NULL) {
+    e.error = 1;
+    goto fin;
+  }
+  for (int s = 0; s < cab.n_slots_byid; s++)
+    slots[s] = -1;
+  for (MapPair *pair = map_iter_first(cat->pelis_byid, &it); pair != NULL;
+       pair = map_iter_next(&it)) {
+    int s = hash_str(pair->key) & (cab.n_slots_byid - 1);
+    while (slots[s] != -1)
+      s = (s + 1) & (cab.n_slots_byid - 1);
+    slots[s] = (intptr_t)pair->value;
+  }
+  escribir_seccion(&e, SEC_BYID, slots, cab.n_slots_byid * sizeof(int));
+
+  if (e.error || !hash_cuerpo(f, e.pos, &cab.hash_cuerpo) ||
+      fseek(f, 0, SEEK_SET) != 0 || fwrite(&cab, sizeof(cab), 1, f) != 1)
+    e.error = 1;
+
+fin:
+  free(id);
+  free(titulo);
+  free(cadenas);
+  free(decadas);
+  free(listas_decada);
+  free(slots);
+  if (fclose(f) != 0)
+    e.error = 1;
+  if (e.error || rename(temporal, ruta) != 0) {
+    remove(temporal);
+    return 0;
+  }
+  return 1;
+}
+
+// Apunta n listas de filas a las secciones sec (inicios) y sec + 1 (filas)
+// de una instantánea mapeada
+static void leer_listas(const char *base, const CabeceraInstantanea *cab,
+                        int sec, ListaFilas *listas, int n) {
+  const int64_t *inicio = (const int64_t *)(base + cab->seccion[sec][0]);
+  int *filas = (int *)(base + cab->seccion[sec + 1][0]);
+  for (int i = 0; i < n; i++) {
+    listas[i].filas = filas + inicio[i];
+    listas[i].total = inicio[i + 1] - inicio[i];
+    listas[i].capacidad = 0; // El arreglo es del mapeo
+  }
+}
+
+// Revisa que las secciones de una instantánea estén dentro del archivo y
+// tengan el tamaño que indican los contadores de la cabecera, y que el resto
+// del archivo no haya cambiado desde que se escribió (su hash coincide con el
+// de la cabecera). Las posiciones de textos y filas guardadas en las
+// secciones se usan sin revisarlas una a una: el hash detecta un archivo
+// dañado, no uno armado a propósito.
+static int instantanea_valida(const char *base, size_t tam,
+                              const CabeceraInstantanea *cab) {
+  if (memcmp(cab->magia, INSTANTANEA_MAGIA, sizeof(cab->magia)) != 0 ||
+      cab->version != INSTANTANEA_VERSION ||
+      cab->orden != INSTANTANEA_ORDEN || cab->tam_size_t != sizeof(size_t) ||
+      cab->total < 0 || cab->n_directores < 0 || cab->n_generos < 0 ||
+      cab->n_generos > MAX_GENEROS || cab->n_directores_min < 0 ||
+      cab->n_decadas < 0 || cab->n_slots_byid <= 0 ||
+      (cab->n_slots_byid & (cab->n_slots_byid - 1)) != 0)
+    return 0;
+
+  uint64_t esperado[N_SECCIONES] = {0};
+  uint64_t total = cab->total;
+  esperado[SEC_ID] = esperado[SEC_TITULO] = total * sizeof(size_t);
+  esperado[SEC_DIRECTOR] = esperado[SEC_ANIO] = esperado[SEC_VOTOS] =
+      esperado[SEC_DURACION] = esperado[SEC_BYRATING] = total * sizeof(int);
+  esperado[SEC_RATING] = total * sizeof(float);
+  esperado[SEC_GENEROS] = total * sizeof(uint32_t);
+  esperado[SEC_DIRECTORES] = cab->n_directores * sizeof(size_t);
+  esperado[SEC_NOMBRES_GENEROS] = cab->n_generos * sizeof(size_t);
+  esperado[SEC_DIRECTORES_MIN] = cab->n_directores_min * sizeof(size_t);
+  esperado[SEC_DIRECTOR_MIN] = cab->n_directores * sizeof(int);
+  esperado[SEC_BYDIR_INICIO] = (cab->n_directores_min + 1) * sizeof(int64_t);
+  esperado[SEC_BYGEN_INICIO] = (cab->n_generos + 1) * sizeof(int64_t);
+  esperado[SEC_DECADAS] = cab->n_decadas * sizeof(int);
+  esperado[SEC_BYDEC_INICIO] = (cab->n_decadas + 1) * sizeof(int64_t);
+  esperado[SEC_BYID] = (uint64_t)cab->n_slots_byid * sizeof(int);
+
+  for (int sec = 0; sec < N_SECCIONES; sec++) {
+    uint64_t off = cab->seccion[sec][0], n = cab->seccion[sec][1];
+    if (off % 8 != 0 || off < sizeof(*cab) || off > tam || n > tam - off)
+      return 0;
+    int filas = sec == SEC_BYDIR_FILAS || sec == SEC_BYGEN_FILAS ||
+                sec == SEC_BYDEC_FILAS;
+    if (sec != SEC_TEXTOS && !filas && n != esperado[sec])
+      return 0;
+    if (filas) { // El último inicio es el total de filas de las listas
+      const int64_t *inicio = (const int64_t *)(base + cab->seccion[sec - 1][0]);
+      uint64_t n_listas = cab->seccion[sec - 1][1] / sizeof(int64_t);
+      if (n != (uint64_t)inicio[n_listas - 1] * sizeof(int))
+        return 0;
+    }
+  }
+  return hash_bytes(base + sizeof(*cab), tam - sizeof(*cab)) ==
+         cab->hash_cuerpo;
+}
+
+// Guarda en la cabecera de la instantánea la fecha de modificación actual del
+// CSV, cuando solo cambió su fecha (por ejemplo, con touch o git checkout) y
+// su hash sigue coincidiendo. Así las cargas siguientes no vuelven a calcular
+// el hash. La cabecera no entra en hash_cuerpo; si no se puede escribir, solo
+// se pierde el atajo.
+static void actualizar_fecha_instantanea(const char *ruta,
+                                         const FirmaArchivo *firma) {
+  int fd = open(ruta, O_WRONLY);
+  if (fd == -1)
+    return;
+  pwrite(fd, &firma->mtime_s, sizeof(int64_t),
+         offsetof(CabeceraInstantanea, csv_mtime_s));
+  pwrite(fd, &firma->mtime_ns, sizeof(int64_t),
+         offsetof(CabeceraInstantanea, csv_mtime_ns));
+  close(fd);
+}
+
+/**
+ * Carga el catálogo desde la instantánea si existe y corresponde al CSV. Es
+ * válida si el CSV tiene el mismo tamaño y fecha de modificación que al
+ * construirla; si solo cambió la fecha, se compara el hash del contenido y, si
+ * coincide, se guarda la nueva fecha en la instantánea.
+ * La instantánea se mapea en memoria y las columnas, listas e índices se usan
+ * directamente desde el mapeo; solo se reconstruyen los conjuntos de cadenas
+ * y el mapa de décadas, que son pequeños.
+ *
+ * @param firma Firma del CSV; si se calcula su hash queda guardado en ella.
+ * @return Retorna 1 si se cargó, 0 si no existe, no es válida, está vencida o
+ * falla la asignación de memoria (el catálogo queda vacío).
+ */
+static int cargar_instantanea(Catalogo *cat, const char *ruta,
+                              const char *ruta_csv, FirmaArchivo *firma) {
+  int fd = open(ruta, O_RDONLY);
+  if (fd == -1)
+    return 0;
+  struct stat st;
+  if (fstat(fd, &st) == -1 || (size_t)st.st_size < sizeof(CabeceraInstantanea)) {
+    close(fd);
+    return 0;
+  }
+  size_t tam = st.st_size;
+  char *base = mmap(NULL, tam, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (base == MAP_FAILED)
+    return 0;
+
+  const CabeceraInstantanea *cab = (const CabeceraInstantanea *)base;
+  int vigente = instantanea_valida(base, tam, cab) &&
+                cab->csv_tamano == firma->tamano;
+  if (vigente && (cab->csv_mtime_s != firma->mtime_s ||
+                  cab->csv_mtime_ns != firma->mtime_ns)) {
+    vigente = hash_archivo(ruta_csv, firma) && cab->csv_hash == firma->hash;
+    if (vigente)
+      actualizar_fecha_instantanea(ruta, firma);
+  }
+  ListaFilas *por_director = NULL, *por_decada = NULL;
+  if (vigente) {
+    por_director = (ListaFilas *)malloc(cab->n_directores_min *
+                                        sizeof(ListaFilas) + 1);
+    por_decada = (ListaFilas *)arena_alloc(
+        cat->arena, cab->n_decadas * sizeof(ListaFilas) + 1);
+  }
+  if (por_director == NULL || por_decada == NULL) {
+    free(por_director);
+    munmap(base, tam);
+    return 0;
+  }
+
+  // Columnas de la tabla
+  TablaPeliculas *tabla = &cat->tabla;
+  const size_t *cadenas;
+  tabla->textos = base + cab->seccion[SEC_TEXTOS][0];
+  tabla->total = cab->total;
+  tabla->capacidad = 0; // Las columnas son del mapeo
+  cat->filas_omitidas = cab->filas_omitidas;
+  tabla->id = (size_t *)(base + cab->seccion[SEC_ID][0]);
+  tabla->titulo = (size_t *)(base + cab->seccion[SEC_TITULO][0]);
+  tabla->director = (int *)(base + cab->seccion[SEC_DIRECTOR][0]);
+  tabla->anio = (int *)(base + cab->seccion[SEC_ANIO][0]);
+  tabla->rating = (float *)(base + cab->seccion[SEC_RATING][0]);
+  tabla->votos = (int *)(base + cab->seccion[SEC_VOTOS][0]);
+  tabla->duracion = (int *)(base + cab->seccion[SEC_DURACION][0]);
+  tabla->generos = (uint32_t *)(base + cab->seccion[SEC_GENEROS][0]);
+  cat->pelis_byrating = (int *)(base + cab->seccion[SEC_BYRATING][0]);
+  cat->instantanea = base;
+  cat->tam_instantanea = tam;
+
+  // Conjuntos de cadenas: se internan en el mismo orden, así los ids coinciden
+  cadenas = (const size_t *)(base + cab->seccion[SEC_DIRECTORES][0]);
+  for (int d = 0; d < cab->n_directores; d++)
+    strpool_intern(tabla->directores, tabla->textos + cadenas[d]);
+  cadenas = (const size_t *)(base + cab->seccion[SEC_NOMBRES_GENEROS][0]);
+  for (int g = 0; g < cab->n_generos; g++)
+    strpool_intern(tabla->nombres_generos, tabla->textos + cadenas[g]);
+  cadenas = (const size_t *)(base + cab->seccion[SEC_DIRECTORES_MIN][0]);
+  for (int dm = 0; dm < cab->n_directores_min; dm++)
+    strpool_intern(cat->directores_min, tabla->textos + cadenas[dm]);
+
+  // Índices
+  cat->director_min = (int *)(base + cab->seccion[SEC_DIRECTOR_MIN][0]);
+  cat->n_director_min = cab->n_directores;
+  cat->cap_director_min = 0;
+  cat->pelis_bydirector = por_director;
+  cat->cap_directores = cab->n_directores_min;
+  leer_listas(base, cab, SEC_BYDIR_INICIO, por_director,
+              cab->n_directores_min);
+  leer_listas(base, cab, SEC_BYGEN_INICIO, cat->pelis_bygenero, cab->n_generos);
+  int *decadas = (int *)(base + cab->seccion[SEC_DECADAS][0]);
+  leer_listas(base, cab, SEC_BYDEC_INICIO, por_decada, cab->n_decadas);
+  for (int i = 0; i < cab->n_decadas; i++)
+    map_insert(cat->pelis_bydecada, &decadas[i], &por_decada[i]);
+  cat->slots_byid = (const int *)(base + cab->seccion[SEC_BYID][0]);
+  cat->n_slots_byid = cab->n_slots_byid;
+
+  // Si falló la memoria al internar, los ids de los conjuntos ya no coinciden
+  // con los de la instantánea: se descarta (esto también la desmapea) y se
+  // carga el CSV
+  if (strpool_size(tabla->directores) != cab->n_directores ||
+      strpool_size(tabla->nombres_generos) != cab->n_generos ||
+      strpool_size(cat->directores_min) != cab->n_directores_min) {
+    reiniciar_catalogo(cat);
+    return 0;
+  }
+  return 1;
+}
+
+/**
+ * Retorna la fila de la película con el id dado, o -1 si no existe. Con una
+ * instantánea se busca en su tabla hash de ids; si no, en pelis_byid.
+ */
+static int fila_por_id(Catalogo *cat, const char *id) {
+  if (cat->slots_byid == NULL) {
+    MapPair *pair = map_search(cat->pelis_byid, (void *)id);
+    return pair ? (intptr_t)pair->value : -1;
+  }
+  int mask = cat->n_slots_byid - 1;
+  for (int s = hash_str((void *)id) & mask;; s = (s + 1) & mask) {
+    int fila = cat->slots_byid[s];
+    if (fila == -1 || strcmp(texto(&cat->tabla, cat->tabla.id[fila]), id) == 0)
+      return fila;
+  }
+}
+
+/**
+ * Carga películas desde un archivo CSV en la tabla de películas, las almacena
+ * en un mapa por ID y construye los índices secundarios del catálogo.
+ *
+ * El archivo se divide en `hilos` tramos de líneas completas; cada hilo carga
+ * su tramo en un catálogo parcial y al final los parciales se fusionan en el
+ * orden del archivo, por lo que el resultado es idéntico al de cargar con un
+ * solo hilo.
+ *
+ * @return Retorna FILMDB_OK o un código de error.
+ */
+static int cargar_peliculas(Catalogo *cat, const char *ruta, int hilos) {
+  // Si hay una instantánea vigente del CSV, se usa en vez de cargarlo. Si no,
+  // se toma la firma completa del CSV antes de cargarlo, para la instantánea
+  // que se guarda al final. Si la ruta de la instantánea no cabe, se carga
+  // el CSV sin instantánea.
+  char ruta_instantanea[PATH_MAX];
+  FirmaArchivo firma;
+  int con_firma = snprintf(ruta_instantanea, sizeof(ruta_instantanea),
+                           "%s.snap", ruta) < (int)sizeof(ruta_instantanea) &&
+                  firma_archivo(ruta, &firma);
+  if (con_firma && cargar_instantanea(cat, ruta_instantanea, ruta, &firma))
+    return FILMDB_OK;
+  con_firma = con_firma && hash_archivo(ruta, &firma);
+
+  // Mapea en memoria el archivo CSV que contiene datos de películas
+  ArchivoCSV *archivo = csv_abrir(ruta);
+  if (archivo == NULL)
+    return FILMDB_ERR_ARCHIVO;
+  CampoCSV campos[COLUMNAS_CSV];
+  if (csv_leer_linea(archivo, ',', campos, COLUMNAS_CSV) < COLUMNAS_CSV) {
+    csv_cerrar(archivo); // Los encabezados no son los de IMDb
+    return FILMDB_ERR_FORMATO;
+  }
+  cat->csv = archivo;
+  cat->tabla.textos = archivo->datos;
+
+  if (hilos > (int)(archivo->tamano / MIN_BYTES_POR_HILO))
+    hilos = archivo->tamano / MIN_BYTES_POR_HILO;
+  if (hilos < 1)
+    hilos = 1;
+
+  size_t *cortes = (size_t *)malloc((hilos + 1) * sizeof(size_t));
+  TramoCarga *tramos = (TramoCarga *)malloc(hilos * sizeof(TramoCarga));
+  pthread_t *ids = (pthread_t *)malloc(hilos * sizeof(pthread_t));
+  int error = cortes == NULL || tramos == NULL || ids == NULL;
+  if (!error) {
+    csv_dividir(archivo, hilos, cortes);
+    for (int i = 0; i < hilos; i++) {
+      tramos[i].csv = csv_tramo(archivo, cortes[i], cortes[i + 1]);
+      tramos[i].omitidas = 0;
+      tramos[i].error = tramos[i].csv == NULL;
+      tramos[i].en_hilo = 0;
+      inicializar_catalogo(&tramos[i].parcial);
+      tramos[i].parcial.tabla.textos = archivo->datos;
+    }
+    // El primer tramo se carga en el hilo actual, y también los tramos cuyo
+    // hilo no se pudo crear
+    for (int i = 1; i < hilos; i++)
+      tramos[i].en_hilo = !tramos[i].error &&
+          pthread_create(&ids[i], NULL, cargar_tramo, &tramos[i]) == 0;
+    for (int i = 0; i < hilos; i++)
+      if (!tramos[i].en_hilo && !tramos[i].error)
+        cargar_tramo(&tramos[i]);
+
+    for (int i = 0; i < hilos; i++) {
+      if (tramos[i].en_hilo)
+        pthread_join(ids[i], NULL);
+      csv_cerrar(tramos[i].csv);
+      cat->filas_omitidas += tramos[i].omitidas;
+      if (tramos[i].error) { // El parcial puede estar a medias: no se fusiona
+        liberar_catalogo(&tramos[i].parcial);
+        error = 1;
+      } else if (!fusionar_catalogo(cat, &tramos[i].parcial)) {
+        error = 1;
+      }
+    }
+  }
+
+  free(cortes);
+  free(tramos);
+  free(ids);
+
+  if (error || !ordenar_por_rating(cat)) {
+    // Deja el catálogo sin cargar, para que filmdb_loaded lo indique y la
+    // carga se pueda reintentar
+    reiniciar_catalogo(cat);
+    return FILMDB_ERR_MEMORIA;
+  }
+  if (con_firma)
+    guardar_instantanea(cat, ruta_instantanea, &firma);
+  return FILMDB_OK;
+}
+
+/**
+ * Filtra las películas cuyo año está en [anio_min, anio_max] y cuyos géneros
+ * incluyen todos los bits de `todos` y, si `alguno` no es 0, al menos uno de
+ * los bits de `alguno`. Recorre solo las columnas de año y géneros, revisando
+ * 8 (AVX2) o 4 (SSE2) películas por instrucción.
+ *
+ * @param salida Arreglo con espacio para tabla->total filas.
+ * @return Retorna el número de filas encontradas, en orden de fila.
+ */
+static int filtrar_peliculas(TablaPeliculas *tabla, uint32_t todos,
+                             uint32_t alguno, int anio_min, int anio_max,
+                             int *salida) {
+  const uint32_t *generos = tabla->generos;
+  const int *anio = tabla->anio;
+  int total = tabla->total, n = 0, f = 0;
+
+#if defined(__AVX2__)
+  __m256i vtodos = _mm256_set1_epi32(todos), valguno = _mm256_set1_epi32(alguno);
+  __m256i vmin = _mm256_set1_epi32(anio_min - 1);
+  __m256i vmax = _mm256_set1_epi32(anio_max + 1);
+  __m256i cero = _mm256_setzero_si256();
+  for (; f + 8 <= total; f += 8) {
+    __m256i g = _mm256_loadu_si256((const __m256i *)(generos + f));
+    __m256i a = _mm256_loadu_si256((const __m256i *)(anio + f));
+    __m256i ok = _mm256_cmpeq_epi32(_mm256_and_si256(g, vtodos), vtodos);
+    if (alguno != 0)
+      ok = _mm256_andnot_si256(
+          _mm256_cmpeq_epi32(_mm256_and_si256(g, valguno), cero), ok);
+    ok = _mm256_and_si256(ok, _mm256_and_si256(_mm256_cmpgt_epi32(a, vmin),
+                                               _mm256_cmpgt_epi32(vmax, a)));
+    unsigned m = _mm256_movemask_ps(_mm256_castsi256_ps(ok));
+    while (m != 0) {
+      salida[n++] = f + __builtin_ctz(m);
+      m &= m - 1;
+    }
+  }
+#elif defined(__SSE2__)
+  __m128i vtodos = _mm_set1_epi32(todos), valguno = _mm_set1_epi32(alguno);
+  __m128i vmin = _mm_set1_epi32(anio_min - 1);
+  __m128i vmax = _mm_set1_epi32(anio_max + 1);
+  __m128i cero = _mm_setzero_si128();
+  for (; f + 4 <= total; f += 4) {
+    __m128i g = _mm_loadu_si128((const __m128i *)(generos + f));
+    __m128i a = _mm_loadu_si128((const __m128i *)(anio + f));
+    __m128i ok = _mm_cmpeq_epi32(_mm_and_si128(g, vtodos), vtodos);
+    if (alguno != 0)
+      ok = _mm_andnot_si128(_mm_cmpeq_epi32(_mm_and_si128(g, valguno), cero),
+                            ok);
+    ok = _mm_and_si128(ok, _mm_and_si128(_mm_cmpgt_epi32(a, vmin),
+                                         _mm_cmplt_epi32(a, vmax)));
+    unsigned m = _mm_movemask_ps(_mm_castsi128_ps(ok));
+    while (m != 0) {
+      salida[n++] = f + __builtin_ctz(m);
+      m &= m - 1;
+    }
+  }
+#endif
+
+  // Filas restantes (o todas, sin SSE2)
+  for (; f < total; f++) {
+    uint32_t g = generos[f];
+    if ((g & todos) == todos && (alguno == 0 || (g & alguno) != 0) &&
+        anio[f] >= anio_min && anio[f] <= anio_max)
+      salida[n++] = f;
+  }
+  return n;
+}
+
+/**
+ * Retorna cuántos errores se aceptan en una búsqueda aproximada de `patron`
+ * (ya plegado): uno cada 5 bytes, siempre que el patrón conserve al menos un
+ * trigrama sin errores, de modo que el índice de trigramas descarte casi todo
+ * el catálogo. Los patrones de menos de 5 bytes deben aparecer exactos.
+ */
+static int errores_permitidos(const char *patron) {
+  int m = strlen(patron);
+  int k = m / 5;
+  while (k > 0 && m - 2 - 3 * k < 1)
+    k--;
+  return k;
+}
+
+/**
+ * Retorna el bit del género cuyo nombre contiene `nombre` con menos errores
+ * (sin distinguir mayúsculas ni acentos), o -1 si ninguno se parece. Los
+ * géneros son pocos, así que se revisan todos sin índice y se acepta un error
+ * cada 4 bytes ("Horor" encuentra Horror).
+ */
+static int genero_parecido(TablaPeliculas *tabla, const char *nombre) {
+  char buscado[64], genero[64];
+  if (strlen(nombre) >= sizeof(buscado))
+    return -1;
+  strcpy(buscado, nombre);
+  plegar_texto(buscado);
+  int mejor = -1, menos_errores = strlen(buscado) / 4 + 1;
+  for (int g = 0; g < strpool_size(tabla->nombres_generos); g++) {
+    const char *original = strpool_get(tabla->nombres_generos, g);
+    if (strlen(original) >= sizeof(genero))
+      continue;
+    strcpy(genero, original);
+    plegar_texto(genero);
+    int e = trigram_errors(genero, buscado, menos_errores - 1);
+    if (e != -1 && e < menos_errores) {
+      mejor = g;
+      menos_errores = e;
+    }
+  }
+  return mejor;
+}
+
+/**
+ * Convierte una expresión de géneros en máscaras para filtrar_peliculas:
+ * "Crime+Drama" pide todos los géneros, "Crime|Thriller" cualquiera de ellos y
+ * "Drama" uno solo. La expresión se modifica al separarla. Con `aproximado`
+ * en 1 los géneros que no existen se reemplazan por el más parecido.
+ *
+ * @return Retorna 1 si todos los géneros existen, 0 si alguno no existe o la
+ *         expresión tiene un género vacío.
+ */
+static int parsear_generos(TablaPeliculas *tabla, char *expr, uint32_t *todos,
+                           uint32_t *alguno, int aproximado) {
+  int es_or = strchr(expr, '|') != NULL;
+  char separador = es_or ? '|' : '+';
+  *todos = *alguno = 0;
+  for (char *nombre = expr;;) {
+    char *fin = strchr(nombre, separador);
+    if (fin != NULL)
+      *fin = '\0';
+    if (*nombre == '\0')
+      return 0; // Expresión vacía o género vacío (como en "Drama+")
+    int g = bit_genero(tabla, nombre, 0);
+    if (g == -1 && aproximado)
+      g = genero_parecido(tabla, nombre);
+    if (g == -1)
+      return 0;
+    if (es_or)
+      *alguno |= 1u << g;
+    else
+      *todos |= 1u << g;
+    if (fin == NULL)
+      return 1;
+    nombre = fin + 1;
+  }
+}
+
+/**
+ * Retorna el índice de títulos del catálogo, creándolo la primera vez: un
+ * arreglo de sufijos de todos los títulos plegados (ver plegar_texto), que
+ * responde búsquedas por parte del título y por su comienzo. Así las cargas
+ * que no buscan por título no pagan su construcción. Retorna NULL si falla la
+ * asignación de memoria.
+ */
+static TextIndex *indice_titulos(Catalogo *cat) {
+  if (cat->titulos != NULL)
+    return cat->titulos;
+  TablaPeliculas *tabla = &cat->tabla;
+  const char **titulos =
+      (const char **)malloc((tabla->total + 1) * sizeof(char *));
+  if (titulos == NULL)
+    return NULL;
+  for (int f = 0; f < tabla->total; f++)
+    titulos[f] = texto(tabla, tabla->titulo[f]);
+  cat->titulos = textindex_create(titulos, tabla->total, plegar_texto,
+                                  cat->hilos);
+  free(titulos);
+  return cat->titulos;
+}
+
+/**
+ * Retorna el índice de trigramas de los directores plegados, creándolo la
+ * primera vez. Sus documentos son los ids de directores_min. Retorna NULL si
+ * falla la asignación de memoria.
+ */
+static TrigramIndex *trigramas_directores(Catalogo *cat) {
+  if (cat->trigramas_directores != NULL)
+    return cat->trigramas_directores;
+  int n = strpool_size(cat->directores_min);
+  const char **nombres = (const char **)malloc((n + 1) * sizeof(char *));
+  if (nombres == NULL)
+    return NULL;
+  for (int dm = 0; dm < n; dm++)
+    nombres[dm] = strpool_get(cat->directores_min, dm);
+  cat->trigramas_directores = trigram_create(nombres, n, NULL);
+  free(nombres);
+  return cat->trigramas_directores;
+}
+
+/**
+ * Retorna el índice de trigramas de los títulos plegados, creándolo la
+ * primera vez. Sus documentos son las filas. Retorna NULL si falla la
+ * asignación de memoria.
+ */
+static TrigramIndex *trigramas_titulos(Catalogo *cat) {
+  if (cat->trigramas_titulos != NULL)
+    return cat->trigramas_titulos;
+  TablaPeliculas *tabla = &cat->tabla;
+  const char **titulos =
+      (const char **)malloc((tabla->total + 1) * sizeof(char *));
+  if (titulos == NULL)
+    return NULL;
+  for (int f = 0; f < tabla->total; f++)
+    titulos[f] = texto(tabla, tabla->titulo[f]);
+  cat->trigramas_titulos = trigram_create(titulos, tabla->total, plegar_texto);
+  free(titulos);
+  return cat->trigramas_titulos;
+}
+
+
+/* ---------- API ---------- */
+
+// Consulta con sus valores ya resueltos contra los índices del catálogo
+typedef struct {
+  int criterios;
+  int vacia;        // Algún criterio no existe en el catálogo: no hay filas
+  int sin_memoria;  // No se pudo preparar (falló la asignación de memoria)
+  int fila_id;      // fila del id
+  int director_min; // id del director en directores_min
+  char *titulo, *prefijo; // partes del título ya plegadas
+  char *director;   // director plegado (solo en búsquedas aproximadas)
+  int errores_director, errores_titulo; // errores aceptados (FILMDB_FUZZY)
+  uint32_t todos, alguno;
+  int anio_min, anio_max;
+  float rating_min, rating_max;
+} ConsultaPreparada;
+
+static void preparar_consulta(Catalogo *cat, const FilmQuery *q,
+                              ConsultaPreparada *p) {
+  memset(p, 0, sizeof(ConsultaPreparada));
+  p->criterios = q->criterios;
+  p->anio_min = INT_MIN + 1;
+  p->anio_max = INT_MAX - 1;
+  if (q->criterios & FILMDB_ID) {
+    p->fila_id = fila_por_id(cat, q->id);
+    p->vacia |= p->fila_id == -1;
+  }
+  int aproximada = (q->criterios & FILMDB_FUZZY) != 0;
+  if (q->criterios & (FILMDB_TITLE | FILMDB_TITLE_PREFIX)) {
+    if (!aproximada || (q->criterios & FILMDB_TITLE_PREFIX))
+      p->sin_memoria |= indice_titulos(cat) == NULL;
+    if (q->criterios & FILMDB_TITLE) {
+      p->titulo = strdup(q->titulo);
+      p->sin_memoria |= p->titulo == NULL;
+      if (p->titulo != NULL) {
+        plegar_texto(p->titulo);
+        p->errores_titulo = errores_permitidos(p->titulo);
+      }
+      if (aproximada)
+        p->sin_memoria |= trigramas_titulos(cat) == NULL;
+    }
+    if (q->criterios & FILMDB_TITLE_PREFIX) {
+      p->prefijo = strdup(q->prefijo);
+      p->sin_memoria |= p->prefijo == NULL;
+      if (p->prefijo != NULL)
+        plegar_texto(p->prefijo);
+    }
+  }
+  if ((q->criterios & FILMDB_DIRECTOR) && aproximada) {
+    p->director = strdup(q->director);
+    p->sin_memoria |= p->director == NULL ||
+                      trigramas_directores(cat) == NULL;
+    if (p->director != NULL) {
+      plegar_texto(p->director);
+      p->errores_director = errores_permitidos(p->director);
+    }
+  } else if (q->criterios & FILMDB_DIRECTOR) {
+    char *director = strdup(q->director);
+    if (director != NULL) {
+      plegar_texto(director);
+      p->director_min = strpool_find(cat->directores_min, director);
+      free(director);
+    }
+    p->vacia |= director == NULL || p->director_min == -1;
+  }
+  if (q->criterios & FILMDB_GENRE) {
+    char *expr = strdup(q->genero);
+    p->vacia |= expr == NULL ||
+                !parsear_generos(&cat->tabla, expr, &p->todos, &p->alguno,
+                                 aproximada);
+    free(expr);
+  }
+  if (q->criterios & FILMDB_DECADE) {
+    if (q->decada > INT_MAX - 9) {
+      p->vacia = 1; // Ningún año cabe en esa década
+    } else {
+      p->anio_min = q->decada - q->decada % 10;
+      p->anio_max = p->anio_min + 9;
+    }
+  }
+  if (q->criterios & FILMDB_RATING) {
+    p->rating_min = q->rating_min;
+    p->rating_max = q->rating_max;
+  }
+}
+
+// Retorna 1 si la fila cumple todos los criterios de la consulta
+static int cumple_consulta(Catalogo *cat, const ConsultaPreparada *p,
+                           int fila) {
+  TablaPeliculas *tabla = &cat->tabla;
+  uint32_t generos = tabla->generos[fila];
+  if ((p->criterios & FILMDB_ID) && fila != p->fila_id)
+    return 0;
+  int dm = cat->director_min[tabla->director[fila]];
+  if (p->director != NULL) {
+    if (trigram_match(cat->trigramas_directores, dm, p->director,
+                      p->errores_director) == -1)
+      return 0;
+  } else if ((p->criterios & FILMDB_DIRECTOR) && dm != p->director_min) {
+    return 0;
+  }
+  if ((generos & p->todos) != p->todos || (p->alguno && !(generos & p->alguno)))
+    return 0;
+  if (tabla->anio[fila] < p->anio_min || tabla->anio[fila] > p->anio_max)
+    return 0;
+  if ((p->criterios & FILMDB_RATING) && (tabla->rating[fila] < p->rating_min ||
+                                         tabla->rating[fila] > p->rating_max))
+    return 0;
+  if ((p->criterios & FILMDB_TITLE) && (p->criterios & FILMDB_FUZZY)) {
+    if (trigram_match(cat->trigramas_titulos, fila, p->titulo,
+                      p->errores_titulo) == -1)
+      return 0;
+  } else if ((p->criterios & FILMDB_TITLE) &&
+             !textindex_match(cat->titulos, fila, p->titulo, 0)) {
+    return 0;
+  }
+  if ((p->criterios & FILMDB_TITLE_PREFIX) &&
+      !textindex_match(cat->titulos, fila, p->prefijo, 1))
+    return 0;
+  return 1;
+}
+
+// Libera los textos plegados de una consulta preparada
+static void liberar_consulta(ConsultaPreparada *p) {
+  free(p->titulo);
+  free(p->prefijo);
+  free(p->director);
+}
+
+typedef struct {
+  int errores, fila;
+} FilaAproximada;
+
+static int menos_errores(const void *a, const void *b) {
+  const FilaAproximada *x = a, *y = b;
+  if (x->errores != y->errores)
+    return x->errores - y->errores;
+  return (x->fila > y->fila) - (x->fila < y->fila);
+}
+
+/**
+ * Ordena las filas de una búsqueda aproximada de menos a más errores (los del
+ * director más los del título), y las de igual número de errores por fila.
+ *
+ * @return Retorna 1 si se pudo ordenar, 0 si falla la asignación de memoria.
+ */
+static int ordenar_por_errores(Catalogo *cat, const ConsultaPreparada *p,
+                               int *filas, int n) {
+  FilaAproximada *orden =
+      (FilaAproximada *)malloc((n > 0 ? n : 1) * sizeof(FilaAproximada));
+  if (orden == NULL)
+    return 0;
+  for (int i = 0; i < n; i++) {
+    int errores = 0;
+    if (p->director != NULL)
+      errores += trigram_match(
+          cat->trigramas_directores,
+          cat->director_min[cat->tabla.director[filas[i]]], p->director,
+          p->errores_director);
+    if ((p->criterios & FILMDB_TITLE) && (p->criterios & FILMDB_FUZZY))
+      errores += trigram_match(cat->trigramas_titulos, filas[i], p->titulo,
+                               p->errores_titulo);
+    orden[i] = (FilaAproximada){errores, filas[i]};
+  }
+  qsort(orden, n, sizeof(FilaAproximada), menos_errores);
+  for (int i = 0; i < n; i++)
+    filas[i] = orden[i].fila;
+  free(orden);
+  return 1;
+}
+
+// Deja en res las filas con calificación en [min, max], en orden de
+// calificación: un tramo del arreglo ordenado, ubicado con búsqueda binaria
+static void rango_calificaciones(Catalogo *cat, float min, float max,
+                                 FilmResult *res) {
+  TablaPeliculas *tabla = &cat->tabla;
+  int ini = 0, fin = tabla->total;
+  while (ini < fin) {
+    int medio = (ini + fin) / 2;
+    if (tabla->rating[cat->pelis_byrating[medio]] < min)
+      ini = medio + 1;
+    else
+      fin = medio;
+  }
+  fin = ini;
+  while (fin < tabla->total && tabla->rating[cat->pelis_byrating[fin]] <= max)
+    fin++;
+  res->films = cat->pelis_byrating + ini;
+  res->total = fin - ini;
+}
+
+FilmDB *filmdb_create() {
+  FilmDB *db = (FilmDB *)malloc(sizeof(FilmDB));
+  if (db == NULL)
+    return NULL; // Fallo en la asignación de memoria
+  inicializar_catalogo(db);
+  return db;
+}
+
+int filmdb_load(FilmDB *db, const char *ruta, int hilos) {
+  if (filmdb_loaded(db))
+    return FILMDB_OK;
+  db->hilos = hilos;
+  return cargar_peliculas(db, ruta, hilos);
+}
+
+int filmdb_loaded(FilmDB *db) {
+  return db->csv != NULL || db->instantanea != NULL;
+}
+
+int filmdb_count(FilmDB *db) { return db->tabla.total; }
+
+int filmdb_skipped(FilmDB *db) { return db->filas_omitidas; }
+
+/**
+ * Ejecuta una consulta ya preparada. Las consultas de un solo criterio con
+ * índice retornan la lista del índice sin copiarla; las demás parten del
+ * criterio más selectivo (id, título, director, género y década) y filtran el
+ * resto con cumple_consulta.
+ *
+ * @return Retorna 1 si se pudo ejecutar, 0 si falla la asignación de memoria.
+ */
+static int ejecutar_consulta(Catalogo *db, const FilmQuery *q,
+                             ConsultaPreparada *p, FilmResult *res) {
+  TablaPeliculas *tabla = &db->tabla;
+  // Un solo criterio: el resultado es la lista del índice, sin copiarla
+  ListaFilas *lista = NULL;
+  switch (q->criterios) {
+  case FILMDB_DIRECTOR:
+    lista = &db->pelis_bydirector[p->director_min];
+    break;
+  case FILMDB_GENRE:
+    if (strpbrk(q->genero, "+|") == NULL) {
+      int g = bit_genero(tabla, q->genero, 0);
+      if (g == -1)
+        return 1; // Género que no existe: resultado vacío
+      lista = &db->pelis_bygenero[g];
+    }
+    break;
+  case FILMDB_DECADE: {
+    MapPair *pair = map_search(db->pelis_bydecada, &p->anio_min);
+    if (pair == NULL)
+      return 1;
+    lista = pair->value;
+    break;
+  }
+  case FILMDB_RATING:
+    rango_calificaciones(db, p->rating_min, p->rating_max, res);
+    return 1;
+  }
+  if (lista != NULL) {
+    res->films = lista->filas;
+    res->total = lista->total;
+    return 1;
+  }
+
+  // En otro caso se parte del criterio más selectivo y se filtran las
+  // filas con el resto
+  int *filas = (int *)malloc(tabla->total * sizeof(int) + 1);
+  if (filas == NULL)
+    return 0;
+  int n = 0;
+  int aproximada = (q->criterios & FILMDB_FUZZY) != 0;
+  int parte_titulo = (q->criterios & FILMDB_TITLE) && !aproximada;
+  if (q->criterios & FILMDB_ID) {
+    filas[n++] = p->fila_id;
+  } else if (parte_titulo || (q->criterios & FILMDB_TITLE_PREFIX)) {
+    // Se prefiere la parte del título: el comienzo ya lo revisa cumple_consulta
+    int prefijo = !parte_titulo;
+    n = textindex_search(db->titulos, prefijo ? p->prefijo : p->titulo,
+                         prefijo, filas);
+    if (n == -1) {
+      free(filas);
+      return 0;
+    }
+  } else if ((q->criterios & FILMDB_DIRECTOR) && !aproximada) {
+    lista = &db->pelis_bydirector[p->director_min];
+    memcpy(filas, lista->filas, lista->total * sizeof(int));
+    n = lista->total;
+  } else if (q->criterios & FILMDB_DIRECTOR) {
+    // Películas de los directores parecidos
+    int n_dm = strpool_size(db->directores_min);
+    int *parecidos = (int *)malloc((n_dm + 1) * sizeof(int));
+    int k = parecidos == NULL ? -1
+                              : trigram_search(db->trigramas_directores,
+                                               p->director, p->errores_director,
+                                               parecidos, NULL);
+    for (int i = 0; i < k; i++) {
+      lista = &db->pelis_bydirector[parecidos[i]];
+      memcpy(filas + n, lista->filas, lista->total * sizeof(int));
+      n += lista->total;
+    }
+    free(parecidos);
+    if (k == -1) {
+      free(filas);
+      return 0;
+    }
+  } else if (q->criterios & FILMDB_TITLE) {
+    n = trigram_search(db->trigramas_titulos, p->titulo, p->errores_titulo,
+                       filas, NULL);
+    if (n == -1) {
+      free(filas);
+      return 0;
+    }
+  } else if (q->criterios & (FILMDB_GENRE | FILMDB_DECADE)) {
+    n = filtrar_peliculas(tabla, p->todos, p->alguno, p->anio_min, p->anio_max,
+                          filas);
+  } else { // Sin criterios: todas las películas
+    for (n = 0; n < tabla->total; n++)
+      filas[n] = n;
+  }
+  int total = 0;
+  for (int i = 0; i < n; i++)
+    if (cumple_consulta(db, p, filas[i]))
+      filas[total++] = filas[i];
+  if (aproximada && (q->criterios & (FILMDB_DIRECTOR | FILMDB_TITLE)) &&
+      !ordenar_por_errores(db, p, filas, total)) {
+    free(filas);
+    return 0;
+  }
+
+  res->films = filas;
+  res->total = total;
+  res->capacity = tabla->total + 1;
+  return 1;
+}
+
+int filmdb_query(FilmDB *db, const FilmQuery *q, FilmResult *res) {
+  res->films = NULL;
+  res->total = res->capacity = 0;
+
+  ConsultaPreparada p;
+  preparar_consulta(db, q, &p);
+  int ok = p.sin_memoria ? 0 : p.vacia ? 1 : ejecutar_consulta(db, q, &p, res);
+  liberar_consulta(&p);
+  return ok;
+}
+
+void filmdb_result_clean(FilmResult *res) {
+  if (res->capacity > 0)
+    free(res->films);
+  res->films = NULL;
+  res->total = res->capacity = 0;
+}
+
+const char *filmdb_id(FilmDB *db, int film) {
+  return texto(&db->tabla, db->tabla.id[film]);
+}
+
+const char *filmdb_title(FilmDB *db, int film) {
+  return texto(&db->tabla, db->tabla.titulo[film]);
+}
+
+const char *filmdb_director(FilmDB *db, int film) {
+  return nombre_director(&db->tabla, film);
+}
+
+int filmdb_year(FilmDB *db, int film) { return db->tabla.anio[film]; }
+
+float filmdb_rating(FilmDB *db, int film) { return db->tabla.rating[film]; }
+
+int filmdb_votes(FilmDB *db, int film) { return db->tabla.votos[film]; }
+
+int filmdb_duration(FilmDB *db, int film) { return db->tabla.duracion[film]; }
+
+int filmdb_genres(FilmDB *db, int film, const char **nombres) {
+  TablaPeliculas *tabla = &db->tabla;
+  uint32_t mascara = tabla->generos[film];
+  int n = 0;
+  for (int g = 0; g < strpool_size(tabla->nombres_generos); g++) {
+    if (!(mascara >> g & 1))
+      continue;
+    // Inserción ordenada (son pocos géneros por película)
+    const char *nombre = strpool_get(tabla->nombres_generos, g);
+    int i = n++;
+    while (i > 0 && strcmp(nombres[i - 1], nombre) > 0) {
+      nombres[i] = nombres[i - 1];
+      i--;
+    }
+    nombres[i] = nombre;
+  }
+  return n;
+}
+
+void filmdb_clean(FilmDB *db) { liberar_catalogo(db); }
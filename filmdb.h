@@ -0,0 +1,101 @@
+#ifndef FILMDB_H
+#define FILMDB_H
+
+// Catálogo de películas con sus índices de búsqueda. Cada película se
+// identifica por un entero (su fila en el catálogo, de 0 a filmdb_count - 1),
+// que se usa con las funciones filmdb_id, filmdb_title, etc.
+typedef struct FilmDB FilmDB;
+
+// Máximo de géneros distintos de un catálogo
+#define FILMDB_MAX_GENRES 32
+
+// Resultados de filmdb_load
+#define FILMDB_OK 0
+#define FILMDB_ERR_ARCHIVO 1 // No se pudo abrir el CSV (ver errno)
+#define FILMDB_ERR_MEMORIA 2 // Falló la asignación de memoria
+#define FILMDB_ERR_FORMATO 3 // El CSV no tiene las columnas de IMDb
+
+// Criterios de una consulta (se combinan con |)
+#define FILMDB_ID 1
+#define FILMDB_DIRECTOR 2
+#define FILMDB_GENRE 4
+#define FILMDB_DECADE 8
+#define FILMDB_RATING 16
+#define FILMDB_TITLE 32        // parte del título
+#define FILMDB_TITLE_PREFIX 64 // comienzo del título
+// Modificador: el director y la parte del título pueden aparecer en el nombre
+// o título con algunos errores (uno cada 5 letras), y los géneros que no
+// existen se reemplazan por el más parecido. Las películas quedan ordenadas
+// de menos a más errores.
+#define FILMDB_FUZZY 128
+
+// Consulta al catálogo: las películas que cumplen todos los criterios
+// indicados en `criterios`. Los campos de criterios no indicados se ignoran.
+typedef struct {
+  int criterios;
+  const char *id;
+  const char *director; // sin distinguir mayúsculas ni acentos
+  const char *genero;   // un género, "A+B" (ambos) o "A|B" (cualquiera)
+  int decada;           // cualquier año de la década
+  float rating_min, rating_max;
+  const char *titulo;  // parte del título, sin distinguir mayúsculas ni acentos
+  const char *prefijo; // comienzo del título, igual que `titulo`
+} FilmQuery;
+
+// Resultado de una consulta: películas en orden. Con capacity 0 el arreglo
+// pertenece al catálogo (es un índice) y no debe modificarse.
+typedef struct {
+  int *films;
+  int total;
+  int capacity;
+} FilmResult;
+
+// Esta función crea un catálogo vacío. Retorna NULL si falla la asignación de
+// memoria.
+FilmDB *filmdb_create();
+
+// Esta función carga el catálogo desde un archivo CSV con formato de IMDb
+// usando hasta `hilos` hilos. Si existe una instantánea vigente del CSV (el
+// archivo `ruta` + ".snap") se usa en vez de leerlo; si no, se crea una al
+// terminar. Retorna FILMDB_OK o un código de error.
+int filmdb_load(FilmDB *db, const char *ruta, int hilos);
+
+// Esta función retorna 1 si el catálogo ya fue cargado, 0 de lo contrario.
+int filmdb_loaded(FilmDB *db);
+
+// Esta función retorna el número de películas del catálogo.
+int filmdb_count(FilmDB *db);
+
+// Esta función retorna el número de filas del CSV que se omitieron al cargar
+// por tener menos columnas que las de IMDb.
+int filmdb_skipped(FilmDB *db);
+
+// Esta función ejecuta una consulta y deja las películas que la cumplen en
+// `res`, que luego se libera con filmdb_result_clean. Las consultas de un
+// solo criterio (y las de década y género) usan los índices del catálogo; las
+// demás combinaciones parten del criterio más selectivo y filtran el resto.
+// Retorna 1 si se pudo ejecutar, 0 si falla la asignación de memoria.
+int filmdb_query(FilmDB *db, const FilmQuery *q, FilmResult *res);
+
+// Esta función libera el resultado de una consulta.
+void filmdb_result_clean(FilmResult *res);
+
+// Funciones de acceso a los datos de una película. Los textos son válidos
+// hasta llamar a filmdb_clean.
+const char *filmdb_id(FilmDB *db, int film);
+const char *filmdb_title(FilmDB *db, int film);
+const char *filmdb_director(FilmDB *db, int film);
+int filmdb_year(FilmDB *db, int film);
+float filmdb_rating(FilmDB *db, int film);
+int filmdb_votes(FilmDB *db, int film);
+int filmdb_duration(FilmDB *db, int film);
+
+// Esta función deja en `nombres` los géneros de una película, en orden
+// alfabético, y retorna cuántos son (a lo más FILMDB_MAX_GENRES).
+int filmdb_genres(FilmDB *db, int film, const char **nombres);
+
+// Esta función elimina todas las películas e índices del catálogo, que luego
+// se libera con free.
+void filmdb_clean(FilmDB *db);
+
+#endif /* FILMDB_H */
@@ -0,0 +1,319 @@
+#include "filmwriter.h"
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+// Tamaño inicial del búfer de salida (crece si una fila no cabe)
+#define TAM_BUFER (1 << 20)
+
+struct FilmWriter {
+  int fd;
+  int formato;
+  int columnas[FILMWRITER_N_COLUMNS];
+  int n_columnas;
+  char *bufer;
+  size_t usado;
+  size_t capacidad;
+  int error; // 1 si falló alguna escritura al descriptor
+};
+
+// Nombres de las columnas, en el orden de FILMWRITER_COL_*
+static const char *nombres_columnas[FILMWRITER_N_COLUMNS] = {
+    "query",  "id",    "title",    "director", "year",
+    "rating", "votes", "duration", "genres"};
+
+int filmwriter_format(const char *nombre) {
+  if (strcmp(nombre, "csv") == 0)
+    return FILMWRITER_CSV;
+  if (strcmp(nombre, "jsonl") == 0)
+    return FILMWRITER_JSONL;
+  if (strcmp(nombre, "tsv") == 0)
+    return FILMWRITER_TSV;
+  return -1;
+}
+
+int filmwriter_columns(const char *lista, int *columnas) {
+  int n = 0, usada[FILMWRITER_N_COLUMNS] = {0};
+  const char *c = lista;
+  while (1) {
+    size_t largo = strcspn(c, ",");
+    int col = -1;
+    for (int k = 0; k < FILMWRITER_N_COLUMNS && col == -1; k++)
+      if (strlen(nombres_columnas[k]) == largo &&
+          strncmp(nombres_columnas[k], c, largo) == 0)
+        col = k;
+    if (col == -1 || usada[col])
+      return -1;
+    usada[col] = 1;
+    columnas[n++] = col;
+    if (c[largo] == '\0')
+      return n;
+    c += largo + 1;
+  }
+}
+
+/* ---------- Búfer ---------- */
+
+// Escribe todo el búfer al descriptor y lo deja vacío
+static void vaciar(FilmWriter *w) {
+  size_t escrito = 0;
+  while (escrito < w->usado && !w->error) {
+    ssize_t n = write(w->fd, w->bufer + escrito, w->usado - escrito);
+    if (n == -1 && errno != EINTR)
+      w->error = 1;
+    else if (n > 0)
+      escrito += n;
+  }
+  w->usado = 0;
+}
+
+/**
+ * Asegura que queden al menos `tam` bytes libres en el búfer, escribiéndolo
+ * si hace falta (o agrandándolo si ni vacío alcanza). Retorna 0 si falla la
+ * asignación de memoria, lo que cuenta como error de escritura.
+ */
+static int reservar(FilmWriter *w, size_t tam) {
+  if (w->usado + tam <= w->capacidad)
+    return 1;
+  vaciar(w);
+  if (tam <= w->capacidad)
+    return 1;
+  char *nuevo = realloc(w->bufer, tam);
+  if (nuevo == NULL) {
+    w->error = 1;
+    return 0;
+  }
+  w->bufer = nuevo;
+  w->capacidad = tam;
+  return 1;
+}
+
+static void agregar_bytes(FilmWriter *w, const char *s, size_t n) {
+  if (!reservar(w, n))
+    return;
+  memcpy(w->bufer + w->usado, s, n);
+  w->usado += n;
+}
+
+static void agregar_caracter(FilmWriter *w, char c) {
+  if (reservar(w, 1))
+    w->bufer[w->usado++] = c;
+}
+
+// Agrega un entero en decimal
+static void agregar_entero(FilmWriter *w, long x) {
+  char tmp[24];
+  int n = 0;
+  unsigned long u = x < 0 ? -(unsigned long)x : (unsigned long)x;
+  do {
+    tmp[sizeof(tmp) - ++n] = '0' + u % 10;
+    u /= 10;
+  } while (u > 0);
+  if (x < 0)
+    tmp[sizeof(tmp) - ++n] = '-';
+  agregar_bytes(w, tmp + sizeof(tmp) - n, n);
+}
+
+// Agrega una calificación con un decimal (como "%.1f")
+static void agregar_rating(FilmWriter *w, float rating) {
+  long decimas = (long)(rating * 10 + (rating < 0 ? -0.5f : 0.5f));
+  if (decimas < 0) {
+    agregar_caracter(w, '-');
+    decimas = -decimas;
+  }
+  agregar_entero(w, decimas / 10);
+  agregar_caracter(w, '.');
+  agregar_caracter(w, '0' + decimas % 10);
+}
+
+/**
+ * Agrega un texto escapado según el formato: en CSV va entre comillas (con
+ * las comillas duplicadas) si contiene el separador, comillas o saltos de
+ * línea; en JSON va entre comillas con los caracteres de control escapados; en
+ * TSV los tabuladores y saltos de línea se reemplazan por espacios.
+ */
+static void agregar_texto(FilmWriter *w, const char *s) {
+  size_t n = strlen(s);
+  if (w->formato == FILMWRITER_CSV) {
+    if (strcspn(s, ",\"\r\n") == n) {
+      agregar_bytes(w, s, n);
+      return;
+    }
+    if (!reservar(w, 2 * n + 2))
+      return;
+    char *p = w->bufer + w->usado;
+    *p++ = '"';
+    for (size_t i = 0; i < n; i++) {
+      if (s[i] == '"')
+        *p++ = '"';
+      *p++ = s[i];
+    }
+    *p++ = '"';
+    w->usado = p - w->bufer;
+  } else if (w->formato == FILMWRITER_JSONL) {
+    if (!reservar(w, 6 * n + 2))
+      return;
+    char *p = w->bufer + w->usado;
+    *p++ = '"';
+    for (size_t i = 0; i < n; i++) {
+      unsigned char c = s[i];
+      if (c == '"' || c == '\\') {
+        *p++ = '\\';
+        *p++ = c;
+      } else if (c < 0x20) {
+        static const char hex[] = "0123456789abcdef";
+        memcpy(p, "\\u00", 4);
+        p[4] = hex[c >> 4];
+        p[5] = hex[c & 15];
+        p += 6;
+      } else {
+        *p++ = c;
+      }
+    }
+    *p++ = '"';
+    w->usado = p - w->bufer;
+  } else {
+    if (!reservar(w, n))
+      return;
+    char *p = w->bufer + w->usado;
+    for (size_t i = 0; i < n; i++)
+      p[i] = s[i] == '\t' || s[i] == '\n' || s[i] == '\r' ? ' ' : s[i];
+    w->usado += n;
+  }
+}
+
+// Agrega los géneros de una película: un arreglo en JSON, "A, B" si no
+static void agregar_generos(FilmWriter *w, FilmDB *db, int f) {
+  const char *nombres[FILMDB_MAX_GENRES];
+  int n = filmdb_genres(db, f, nombres);
+  if (w->formato == FILMWRITER_JSONL) {
+    agregar_caracter(w, '[');
+    for (int i = 0; i < n; i++) {
+      if (i > 0)
+        agregar_caracter(w, ',');
+      agregar_texto(w, nombres[i]);
+    }
+    agregar_caracter(w, ']');
+    return;
+  }
+
+  // Se arma la lista completa para escaparla como un solo campo
+  size_t largo = 0;
+  for (int i = 0; i < n; i++)
+    largo += strlen(nombres[i]) + 2;
+  char local[512], *lista = largo < sizeof(local) ? local : malloc(largo + 1);
+  if (lista == NULL)
+    return;
+  char *p = lista;
+  for (int i = 0; i < n; i++) {
+    if (i > 0) {
+      memcpy(p, ", ", 2);
+      p += 2;
+    }
+    size_t l = strlen(nombres[i]);
+    memcpy(p, nombres[i], l);
+    p += l;
+  }
+  *p = '\0';
+  agregar_texto(w, lista);
+  if (lista != local)
+    free(lista);
+}
+
+/* ---------- Escritor ---------- */
+
+FilmWriter *filmwriter_create(int fd, int formato, const int *columnas,
+                              int n_columnas) {
+  FilmWriter *w = malloc(sizeof(FilmWriter));
+  if (w == NULL)
+    return NULL;
+  w->bufer = malloc(TAM_BUFER);
+  if (w->bufer == NULL) {
+    free(w);
+    return NULL;
+  }
+  w->fd = fd;
+  w->formato = formato;
+  w->usado = 0;
+  w->capacidad = TAM_BUFER;
+  w->error = 0;
+  w->n_columnas = columnas ? n_columnas : FILMWRITER_N_COLUMNS;
+  for (int k = 0; k < w->n_columnas; k++)
+    w->columnas[k] = columnas ? columnas[k] : k;
+
+  // CSV y TSV empiezan con los nombres de las columnas
+  if (formato != FILMWRITER_JSONL) {
+    char separador = formato == FILMWRITER_CSV ? ',' : '\t';
+    for (int k = 0; k < w->n_columnas; k++) {
+      if (k > 0)
+        agregar_caracter(w, separador);
+      agregar_texto(w, nombres_columnas[w->columnas[k]]);
+    }
+    agregar_caracter(w, '\n');
+  }
+  return w;
+}
+
+void filmwriter_result(FilmWriter *w, FilmDB *db, const FilmResult *res,
+                       long consulta) {
+  char separador = w->formato == FILMWRITER_TSV ? '\t' : ',';
+  for (int i = 0; i < res->total; i++) {
+    int f = res->films[i];
+    if (w->formato == FILMWRITER_JSONL)
+      agregar_caracter(w, '{');
+    for (int k = 0; k < w->n_columnas; k++) {
+      int col = w->columnas[k];
+      if (k > 0)
+        agregar_caracter(w, separador);
+      if (w->formato == FILMWRITER_JSONL) {
+        agregar_texto(w, nombres_columnas[col]);
+        agregar_caracter(w, ':');
+      }
+      switch (col) {
+      case FILMWRITER_COL_QUERY:
+        agregar_entero(w, consulta);
+        break;
+      case FILMWRITER_COL_ID:
+        agregar_texto(w, filmdb_id(db, f));
+        break;
+      case FILMWRITER_COL_TITLE:
+        agregar_texto(w, filmdb_title(db, f));
+        break;
+      case FILMWRITER_COL_DIRECTOR:
+        agregar_texto(w, filmdb_director(db, f));
+        break;
+      case FILMWRITER_COL_YEAR:
+        agregar_entero(w, filmdb_year(db, f));
+        break;
+      case FILMWRITER_COL_RATING:
+        agregar_rating(w, filmdb_rating(db, f));
+        break;
+      case FILMWRITER_COL_VOTES:
+        agregar_entero(w, filmdb_votes(db, f));
+        break;
+      case FILMWRITER_COL_DURATION:
+        agregar_entero(w, filmdb_duration(db, f));
+        break;
+      case FILMWRITER_COL_GENRES:
+        agregar_generos(w, db, f);
+        break;
+      }
+    }
+    if (w->formato == FILMWRITER_JSONL)
+      agregar_caracter(w, '}');
+    agregar_caracter(w, '\n');
+  }
+}
+
+int filmwriter_flush(FilmWriter *w) {
+  vaciar(w);
+  return !w->error;
+}
+
+void filmwriter_clean(FilmWriter *w) {
+  vaciar(w);
+  free(w->bufer);
+  w->bufer = NULL;
+  w->usado = w->capacidad = 0;
+}
@@ -0,0 +1,60 @@
+#ifndef FILMWRITER_H
+#define FILMWRITER_H
+
+#include "filmdb.h"
+
+// Escritor de resultados de consultas en formatos para otros programas. Las
+// filas se arman en un búfer grande que se reutiliza y se escribe al
+// descriptor con pocas llamadas a write, sin pasar por printf.
+typedef struct FilmWriter FilmWriter;
+
+// Formatos de salida
+#define FILMWRITER_CSV 0   // CSV con cabecera; campos entre comillas si hace falta
+#define FILMWRITER_JSONL 1 // Un objeto JSON por película
+#define FILMWRITER_TSV 2   // Separado por tabuladores con cabecera; los
+                           // tabuladores y saltos de línea de los textos se
+                           // reemplazan por espacios
+
+// Columnas que se pueden escribir
+#define FILMWRITER_COL_QUERY 0 // Número de la consulta (su línea en el lote)
+#define FILMWRITER_COL_ID 1
+#define FILMWRITER_COL_TITLE 2
+#define FILMWRITER_COL_DIRECTOR 3
+#define FILMWRITER_COL_YEAR 4
+#define FILMWRITER_COL_RATING 5
+#define FILMWRITER_COL_VOTES 6
+#define FILMWRITER_COL_DURATION 7
+#define FILMWRITER_COL_GENRES 8 // En JSON es un arreglo; si no, "A, B"
+#define FILMWRITER_N_COLUMNS 9
+
+// Esta función retorna el formato con el nombre dado ("csv", "jsonl" o "tsv"),
+// o -1 si no existe.
+int filmwriter_format(const char *nombre);
+
+// Esta función lee una lista de columnas separadas por comas (por ejemplo
+// "id,title,year"; los nombres son los de FILMWRITER_COL_* en minúsculas) y
+// las deja en `columnas`, que debe tener espacio para FILMWRITER_N_COLUMNS.
+// Retorna cuántas son, o -1 si hay una columna inválida o repetida.
+int filmwriter_columns(const char *lista, int *columnas);
+
+// Esta función crea un escritor hacia el descriptor `fd` con las columnas
+// dadas (NULL para todas) y deja la cabecera en el búfer si el formato la
+// tiene. Retorna NULL si falla la asignación de memoria.
+FilmWriter *filmwriter_create(int fd, int formato, const int *columnas,
+                              int n_columnas);
+
+// Esta función agrega al búfer las películas de un resultado, indicando el
+// número de consulta que se escribe en la columna query. El búfer se escribe
+// al descriptor cuando se llena.
+void filmwriter_result(FilmWriter *w, FilmDB *db, const FilmResult *res,
+                       long consulta);
+
+// Esta función escribe al descriptor lo que queda en el búfer. Retorna 1 si
+// todo lo escrito hasta ahora llegó al descriptor, 0 si hubo un error.
+int filmwriter_flush(FilmWriter *w);
+
+// Esta función escribe lo pendiente y libera el búfer del escritor, que luego
+// se libera con free.
+void filmwriter_clean(FilmWriter *w);
+
+#endif /* FILMWRITER_H */
@@ -1,29 +1,17 @@
-#include "tdas/list.h"
+#include "filmdb.h"
+#include "filmwriter.h"
 #include "tdas/extra.h"
-#include "tdas/map.h"
 #include <ctype.h>
+#include <errno.h>
+#include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 
-typedef struct {
-    char id[100];
-    char title[100];
-    char director[300];
-    struct List {
-        struct Node *head;  // Puntero al primer nodo de la lista
-        struct Node *tail;  // Puntero al último nodo de la lista
-        int size;           // Tamaño de la lista (número de elementos)
-    } *genres;              // Lista de géneros
-    float rating;
-    int year;
-} Film;
-
-
-typedef struct Node {
-    void *data;
-    struct Node *next;
-} Node;
+// Archivo de películas (su instantánea binaria queda junto a él, ver
+// filmdb_load)
+#define RUTA_CSV "data/Top1500.csv"
 
 // Menú principal
 void mostrarMenuPrincipal() {
@@ -39,329 +27,644 @@ void mostrarMenuPrincipal() {
   puts("5) Buscar por década");
   puts("6) Buscar por rango de calificaciones");
   puts("7) Buscar por década y género");
+  puts("9) Buscar por título");
   puts("8) Salir");
 }
 
 /**
- * Compara dos claves de tipo string para determinar si son iguales.
- * Esta función se utiliza para inicializar mapas con claves de tipo string.
+ * Carga las películas del archivo CSV en el catálogo, informando al usuario
+ * si ya estaban cargadas o si ocurre un error.
  *
- * @param key1 Primer puntero a la clave string.
- * @param key2 Segundo puntero a la clave string.
- * @return Retorna 1 si las claves son iguales, 0 de lo contrario.
+ * @return Retorna FILMDB_OK (también si ya estaban cargadas) o el código de
+ * error de filmdb_load.
  */
-int is_equal_str(void *key1, void *key2) {
-  return strcmp((char *)key1, (char *)key2) == 0;
+int cargar_peliculas(FilmDB *db, int hilos) {
+  if (filmdb_loaded(db)) {
+    puts("Las películas ya fueron cargadas");
+    return FILMDB_OK;
+  }
+  int error = filmdb_load(db, RUTA_CSV, hilos);
+  if (error == FILMDB_ERR_ARCHIVO)
+    perror("Error al abrir el archivo");
+  else if (error == FILMDB_ERR_MEMORIA)
+    perror("Error al reservar memoria");
+  else if (error == FILMDB_ERR_FORMATO)
+    fprintf(stderr, "El archivo %s no tiene el formato de IMDb\n", RUTA_CSV);
+  else if (filmdb_skipped(db) > 0)
+    fprintf(stderr, "Se omitieron %d filas incompletas del archivo\n",
+            filmdb_skipped(db));
+  return error;
+}
+
+// Muestra los géneros de una película, en orden alfabético (la línea se arma
+// completa y se escribe de una vez)
+void mostrar_generos(FilmDB *db, int f) {
+  const char *nombres[FILMDB_MAX_GENRES];
+  int n = filmdb_genres(db, f, nombres);
+  char linea[1024];
+  size_t largo = snprintf(linea, sizeof(linea), "Géneros: ");
+  for (int i = 0; i < n && largo < sizeof(linea); i++)
+    largo += snprintf(linea + largo, sizeof(linea) - largo, "%s, ", nombres[i]);
+  fputs(linea, stdout);
+  putchar('\n');
 }
 
 /**
- * Compara dos claves de tipo entero para determinar si son iguales.
- * Esta función se utiliza para inicializar mapas con claves de tipo entero.
- *
- * @param key1 Primer puntero a la clave entera.
- * @param key2 Segundo puntero a la clave entera.
- * @return Retorna 1 si las claves son iguales, 0 de lo contrario.
+ * Muestra las películas de una consulta hecha en forma aproximada
+ * (FILMDB_FUZZY), de la más parecida a la menos, para cuando la consulta
+ * exacta no encuentra nada (por ejemplo, "kubrik" encuentra a Stanley
+ * Kubrick).
  */
-int is_equal_int(void *key1, void *key2) {
-    return *(int *)key1 == *(int *)key2; // Compara valores enteros directamente
+void mostrar_parecidas(FilmDB *db, FilmQuery q) {
+  q.criterios |= FILMDB_FUZZY;
+  FilmResult res;
+  if (filmdb_query(db, &q, &res) && res.total > 0)
+    puts("Películas con nombres parecidos:");
+  for (int i = 0; i < res.total; i++) {
+    int f = res.films[i];
+    printf("ID: %s, Título: %s, Director: %s, Año: %d\n", filmdb_id(db, f),
+           filmdb_title(db, f), filmdb_director(db, f), filmdb_year(db, f));
+  }
+  filmdb_result_clean(&res);
 }
+
 /**
- * Carga películas desde un archivo CSV y las almacena en un mapa por ID.
+ * Muestra la información de la película con el id dado.
  */
-void cargar_peliculas(Map *pelis_byid) {
-  // Intenta abrir el archivo CSV que contiene datos de películas
-  FILE *archivo = fopen("data/Top1500.csv", "r");
-  if (archivo == NULL) {
-    perror("Error al abrir el archivo");
+void consultar_por_id(FilmDB *db, const char *id) {
+  FilmQuery q = {FILMDB_ID};
+  q.id = id;
+  FilmResult res;
+  if (!filmdb_query(db, &q, &res)) {
+    perror("Error al reservar memoria");
     return;
   }
 
-  char **campos;
-  // Leer y parsear una línea del archivo CSV. La función devuelve un array de
-  // strings, donde cada elemento representa un campo de la línea CSV procesada.
-  campos = leer_linea_csv(archivo, ','); // Lee los encabezados del CSV
-
-  // Lee cada línea del archivo CSV hasta el final
-  while ((campos = leer_linea_csv(archivo, ',')) != NULL) {
-    // Crea una nueva estructura Film y almacena los datos de cada película
-    Film *peli = (Film *)malloc(sizeof(Film));
-    strcpy(peli->id, campos[1]);        // Asigna ID
-    strcpy(peli->title, campos[5]);     // Asigna título
-    strcpy(peli->director, campos[14]); // Asigna director
-    peli->genres = list_create();       // Asigna género
-    peli->year =
-        atoi(campos[10]); // Asigna año, convirtiendo de cadena a entero
-    // Divide los géneros separados por comas y los agrega a la lista de géneros
-    char *token = strtok(campos[9], ",");
-    while (token != NULL) {
-        // Elimina las comillas al principio y al final de cada género
-        char *genre = strdup(token);
-        genre[strlen(genre) - 1] = '\0'; // Elimina la comilla al final
-        memmove(genre, genre + 1, strlen(genre) - 1); // Elimina la comilla al principio
-
-        // Copia el género en un nuevo espacio de memoria para evitar problemas de punteros
-        char *genre_copy = malloc(strlen(genre) + 1);
-        strcpy(genre_copy, genre); // Copia el género sin las comillas
-
-        list_pushBack(peli->genres, genre_copy);
-        token = strtok(NULL, ",");
-    }
-
-    // Inserta la película en el mapa usando el ID como clave
-    map_insert(pelis_byid, peli->id, peli);
+  // Si se encontró la película, muestra su información
+  if (res.total > 0) {
+    // Muestra el título y el año de la película
+    printf("Título: %s, Año: %d\n", filmdb_title(db, res.films[0]),
+           filmdb_year(db, res.films[0]));
+  } else {
+    // Si no se encuentra la película, informa al usuario
+    printf("La película con id %s no existe\n", id);
   }
-  
-  fclose(archivo); // Cierra el archivo después de leer todas las líneas
+  filmdb_result_clean(&res);
 }
 
-
 /**
- * Busca y muestra la información de películas por id en un mapa.
+ * Busca y muestra la información de películas por id.
  */
-void buscar_por_id(Map *pelis_byid) {
+void buscar_por_id(FilmDB *db) {
   char id[100]; // Buffer para almacenar el ID de la película
 
   // Solicita al usuario el ID de la película
   printf("Ingrese el id de la película: ");
-  scanf("%s", id); // Lee el ID del teclado
-
-  // Busca el par clave-valor en el mapa usando el ID proporcionado
-  MapPair *pair = map_search(pelis_byid, id);
-
-  // Si se encontró el par clave-valor, se extrae y muestra la información de la
-  // película
-  if (pair != NULL) {
-    Film *peli =
-        pair->value; // Obtiene el puntero a la estructura de la película
-    // Muestra el título y el año de la película
-    printf("Título: %s, Año: %d\n", peli->title, peli->year);
-  } else {
-    // Si no se encuentra la película, informa al usuario
-    printf("La película con id %s no existe\n", id);
-  }
+  scanf("%99s", id); // Lee el ID del teclado
+  consultar_por_id(db, id);
 }
 
 /**
- * Busca y muestra la información de películas por género en un mapa.
+ * Muestra la información de las películas de un género o combinación de
+ * géneros ("Crime+Drama" o "Crime|Thriller").
  */
-
-void buscar_por_genero(Map *pelis_byid) {
-    char genero[100]; // Buffer para almacenar el género ingresado por el usuario
-
-    // Solicita al usuario el género de la película
-    printf("Ingrese el género de la película: ");
-    scanf("%s", genero); // Lee el género del teclado
-
-    // Itera sobre el mapa para buscar películas por género
-    MapPair *pair = map_first(pelis_byid);
-    int found = 0; // Variable para rastrear si se encontraron películas del género ingresado
-
-    while (pair != NULL) {
-        Film *peli = pair->value;
-        // Itera sobre la lista de géneros de la película
-        Node *current = peli->genres->head;
-        while (current != NULL) {
-            char *genre = (char *)current->data;
-
-            // Compara el género actual de la película con el género proporcionado por el usuario
-            if (strcmp(genre, genero) == 0) {
-                // Si el género coincide, muestra la información de la película
-                printf("ID: %s, Título: %s, Director: %s, Año: %d\n", peli->id, peli->title,
-                       peli->director, peli->year);
-                found = 1; // Establece found a 1 si se encuentra una película del género
-                break; // Sal del bucle interno si se encuentra el género
-            }
-            current = current->next; // Avanza al siguiente género en la lista de la película
-        }
-        pair = map_next(pelis_byid); // Avanza al siguiente par en el mapa
+void consultar_por_genero(FilmDB *db, const char *genero) {
+    FilmQuery q = {FILMDB_GENRE};
+    q.genero = genero;
+    FilmResult res;
+    if (!filmdb_query(db, &q, &res)) {
+        perror("Error al reservar memoria");
+        return;
     }
 
     // Si no se encuentran películas del género ingresado, informa al usuario
-    if (!found) {
+    if (res.total == 0) {
         printf("No se encontraron películas del género %s\n", genero);
+        mostrar_parecidas(db, q);
     }
-}
 
+    // Muestra la información de cada película del género
+    for (int i = 0; i < res.total; i++) {
+        int f = res.films[i];
+        printf("ID: %s, Título: %s, Director: %s, Año: %d\n", filmdb_id(db, f),
+               filmdb_title(db, f), filmdb_director(db, f), filmdb_year(db, f));
+    }
+    filmdb_result_clean(&res);
+}
 
 /**
- * Busca y muestra la información de películas por director en un mapa.
+ * Busca y muestra la información de películas por género.
  */
-void buscar_por_director(Map *pelis_byid) {
-    char director[300]; // Buffer para almacenar el nombre del director
+void buscar_por_genero(FilmDB *db) {
+    char genero[100]; // Buffer para almacenar el género ingresado por el usuario
 
-    // Solicita al usuario el nombre del director
-    printf("Ingrese el nombre del director: ");
-    scanf(" %[^\n]", director);
+    // Solicita al usuario el género de la película
+    printf("Ingrese el género de la película (Crime+Drama: ambos, "
+           "Crime|Thriller: cualquiera): ");
+    scanf("%99s", genero); // Lee el género del teclado
+    consultar_por_genero(db, genero);
+}
 
-    // Convierte el nombre del director ingresado por el usuario a minúsculas
-    for (int i = 0; director[i]; i++) {
-        director[i] = tolower(director[i]);
+/**
+ * Muestra la información de las películas de un director (sin distinguir
+ * mayúsculas).
+ */
+void consultar_por_director(FilmDB *db, const char *director) {
+    FilmQuery q = {FILMDB_DIRECTOR};
+    q.director = director;
+    FilmResult res;
+    if (!filmdb_query(db, &q, &res)) {
+        perror("Error al reservar memoria");
+        return;
     }
 
-    // Itera sobre el mapa para buscar y mostrar películas del director ingresado
-    MapPair *pair = map_first(pelis_byid);
-    int found = 0; // Variable para rastrear si se encontró alguna película del director
-    while (pair != NULL) {
-        Film *peli = pair->value;
-        // Convierte el nombre del director almacenado en la estructura de película a minúsculas
-        char director_lower[300];
-        strcpy(director_lower, peli->director);
-        for (int i = 0; director_lower[i]; i++) {
-            director_lower[i] = tolower(director_lower[i]);
-        }
-        // Compara el nombre del director de la película actual con el nombre ingresado por el usuario (en minúsculas)
-        if (strcmp(director_lower, director) == 0) {
-            // Si el director coincide, muestra la información de la película
-            printf("ID: %s, Título: %s, Año: %d\n", peli->id, peli->title, peli->year);
-            // Muestra los géneros de la película iterando sobre la lista de géneros
-            Node *current_genre = peli->genres->head;
-            printf("Géneros: ");
-            while (current_genre != NULL) {
-                printf("%s, ", (char *)current_genre->data);
-                current_genre = current_genre->next;
-            }
-            printf("\n");
-            found = 1; // Indica que se encontró al menos una película del director
-        }
-        pair = map_next(pelis_byid); // Avanza al siguiente par en el mapa
+    // Si no se encontraron películas del director ingresado, informa al usuario
+    if (res.total == 0) {
+        printf("No se encontraron películas del director ");
+        for (const char *c = director; *c; c++)
+            putchar(tolower((unsigned char)*c));
+        printf("\n");
+        mostrar_parecidas(db, q);
     }
 
-    // Si no se encontraron películas del director ingresado, informa al usuario
-    if (!found) {
-        printf("No se encontraron películas del director %s\n", director);
+    for (int i = 0; i < res.total; i++) {
+        int f = res.films[i];
+        // Muestra la información de la película y sus géneros
+        printf("ID: %s, Título: %s, Año: %d\n", filmdb_id(db, f),
+               filmdb_title(db, f), filmdb_year(db, f));
+        mostrar_generos(db, f);
     }
+    filmdb_result_clean(&res);
 }
 
 /**
- * Busca y muestra la información de películas por rango de calificaciones en un
- * mapa.
+ * Busca y muestra la información de películas por director.
  */
-  void buscar_por_decada(Map *pelis_byid)  {
+void buscar_por_director(FilmDB *db) {
+    char director[300]; // Buffer para almacenar el nombre del director
 
-    printf("Ingrese la década (ejemplo: 1980s, 2010s): ");
-    char decada_str[100];    // Buffer para almacenar la década ingresada
-    scanf("%s", decada_str); // Lee la década del teclado
-    // Extrae el número de la cadena de década (eliminando el sufijo "s" o "s")
-    int decada = atoi(decada_str);
-    int inicio_decada = decada - (decada % 10);
-    int fin_decada = inicio_decada + 9;
-    // Itera sobre el mapa para buscar y mostrar peliculas de la decada ingresada
-    
-    MapPair *pair = map_first(pelis_byid);
-    int found = 0; // Variable para rastrear si se encontró alguna película de la decada
-    while (pair != NULL) {
-      Film *peli = pair->value;
-      // Comprueba si el año de la pelicula está dentro del rango de la decada
-      // ingresada por el usuario
-      if (peli->year >= inicio_decada && peli->year <= fin_decada) {
-        // Si el año de la pelicula esta dentro del rango de la decada, muestra la
-        // información de la pelicula
-        printf("ID: %s, Título: %s, Director: %s\n", peli->id,
-               peli->title, peli->director);
-        found = 1; // Indica que se encontro al menos una película de la decada
-      }
-      pair = map_next(pelis_byid); // Avanza al siguiente par en el mapa
+    // Solicita al usuario el nombre del director
+    printf("Ingrese el nombre del director: ");
+    scanf(" %299[^\n]", director);
+    consultar_por_director(db, director);
+}
+
+/**
+ * Muestra la información de las películas de la década que contiene el año
+ * dado.
+ */
+  void consultar_por_decada(FilmDB *db, int decada)  {
+    FilmQuery q = {FILMDB_DECADE};
+    q.decada = decada;
+    FilmResult res;
+    if (!filmdb_query(db, &q, &res)) {
+        perror("Error al reservar memoria");
+        return;
     }
 
     // Si no se encontraron películas de la decada ingresada, informa al usuario
-    if (!found) {
-      printf("No se encontraron películas de la década %d\n", inicio_decada);
+    if (res.total == 0)
+      printf("No se encontraron películas de la década %d\n",
+             decada - (decada % 10));
+
+    for (int i = 0; i < res.total; i++) {
+      int f = res.films[i];
+      printf("ID: %s, Título: %s, Director: %s\n", filmdb_id(db, f),
+             filmdb_title(db, f), filmdb_director(db, f));
     }
+    filmdb_result_clean(&res);
   }
 
-void buscar_por_rango_calificaciones(Map *pelis_byid) {
-  float rango_min,
-      rango_max; // Variables para almacenar el rango de calificaciones
+/**
+ * Busca y muestra la información de películas por década.
+ */
+  void buscar_por_decada(FilmDB *db)  {
+    printf("Ingrese la década (ejemplo: 1980s, 2010s): ");
+    char decada_str[100];    // Buffer para almacenar la década ingresada
+    scanf("%99s", decada_str); // Lee la década del teclado
+    // Extrae el número de la cadena de década (eliminando el sufijo "s")
+    consultar_por_decada(db, atoi(decada_str));
+  }
 
-  // Solicita al usuario el rango de calificaciones
-  printf("Ingrese el rango de calificaciones (ejemplo: 6.0-6.4): ");
-  scanf("%f-%f", &rango_min, &rango_max); // Lee el rango de calificaciones del teclado
+/**
+ * Muestra la información de las películas con calificación en
+ * [rango_min, rango_max], de menor a mayor calificación.
+ */
+void consultar_por_rango_calificaciones(FilmDB *db, float rango_min,
+                                        float rango_max) {
+  FilmQuery q = {FILMDB_RATING};
+  q.rating_min = rango_min;
+  q.rating_max = rango_max;
+  FilmResult res;
+  if (!filmdb_query(db, &q, &res)) {
+    perror("Error al reservar memoria");
+    return;
+  }
 
-  // Itera sobre el mapa para buscar y mostrar películas dentro del rango de calificaciones
-  MapPair *pair = map_first(pelis_byid);
-  int found = 0; // Variable para rastrear si se encontró alguna película dentro del rango
-  while (pair != NULL) {
-    Film *peli = pair->value;
-    // Compara la calificación de la película actual con el rango ingresado por el usuario
-    if (peli->rating >= rango_min && peli->rating <= rango_max) {
-      // Si la calificación está dentro del rango, muestra la información de la película
-      printf("ID: %s, Título: %s, Director: %s, Año: %d\n", peli->id,
-             peli->title, peli->director, peli->year);
-      found =
-          1; // Indica que se encontró al menos una película dentro del rango
-    }
-    pair = map_next(pelis_byid); // Avanza al siguiente par en el mapa
+  // Recorre las películas dentro del rango de calificaciones
+  for (int i = 0; i < res.total; i++) {
+    int f = res.films[i];
+    printf("ID: %s, Título: %s, Director: %s, Año: %d\n", filmdb_id(db, f),
+           filmdb_title(db, f), filmdb_director(db, f), filmdb_year(db, f));
   }
 
   // Si no se encontraron películas dentro del rango de calificaciones, informa al usuario
-  if (!found) {
+  if (res.total == 0) {
     printf("No se encontraron películas dentro del rango de calificaciones %.1f-%.1f\n",
            rango_min, rango_max);
   }
+  filmdb_result_clean(&res);
+}
+
+/**
+ * Busca y muestra la información de películas por rango de calificaciones.
+ */
+void buscar_por_rango_calificaciones(FilmDB *db) {
+  float rango_min = 0,
+      rango_max = -1; // Variables para almacenar el rango de calificaciones
+
+  // Solicita al usuario el rango de calificaciones
+  printf("Ingrese el rango de calificaciones (ejemplo: 6.0-6.4): ");
+  scanf("%f-%f", &rango_min, &rango_max); // Lee el rango de calificaciones del teclado
+  consultar_por_rango_calificaciones(db, rango_min, rango_max);
 }
 
 /**
- * Busca y muestra la información de películas por década y género en un mapa.
+ * Muestra la información de las películas de una década y género (o
+ * combinación de géneros).
  */
-void buscar_por_decada_y_genero(Map *pelis_byid) {
+void consultar_por_decada_y_genero(FilmDB *db, int decada,
+                                   const char *genero) {
+    FilmQuery q = {FILMDB_DECADE | FILMDB_GENRE};
+    q.decada = decada;
+    q.genero = genero;
+    FilmResult res;
+    if (!filmdb_query(db, &q, &res)) {
+        perror("Error al reservar memoria");
+        return;
+    }
+
+    for (int i = 0; i < res.total; i++) {
+        int f = res.films[i];
+        printf("ID: %s, Título: %s, Director: %s, Calificación: %.1f\n",
+               filmdb_id(db, f), filmdb_title(db, f), filmdb_director(db, f),
+               filmdb_rating(db, f));
+    }
+
+    // Si no se encontraron películas del género y década ingresados, informa al usuario
+    if (res.total == 0) {
+        printf("No se encontraron películas del género %s de la década %d\n",
+               genero, decada - decada % 10);
+    }
+    filmdb_result_clean(&res);
+}
+
+/**
+ * Busca y muestra la información de películas por década y género.
+ */
+void buscar_por_decada_y_genero(FilmDB *db) {
     char decada_str[100]; // Buffer para almacenar la década ingresada por el usuario
     char genero[100];     // Buffer para almacenar el género ingresado por el usuario
 
     // Solicita al usuario la década y el género de la película
     printf("Ingrese la década (ejemplo: 1980s, 2010s): ");
-    scanf("%s", decada_str); // Lee la década del teclado
-    printf("Ingrese el género de la película: ");
-    scanf("%s", genero); // Lee el género del teclado
-
-    // Elimina la 's' al final si está presente
-    size_t len = strlen(decada_str);
-    if (len > 0 && decada_str[len - 1] == 's') {
-        decada_str[len - 1] = '\0';
+    scanf("%99s", decada_str); // Lee la década del teclado
+    printf("Ingrese el género de la película (Crime+Drama: ambos, "
+           "Crime|Thriller: cualquiera): ");
+    scanf("%99s", genero); // Lee el género del teclado
+
+    // Convierte la década a su año (ignora la 's' final)
+    consultar_por_decada_y_genero(db, atoi(decada_str), genero);
+}
+
+/**
+ * Muestra la información de las películas cuyo título contiene `titulo` (o
+ * empieza con él si `prefijo` es 1), sin distinguir mayúsculas ni acentos.
+ */
+void consultar_por_titulo(FilmDB *db, const char *titulo, int prefijo) {
+  FilmQuery q = {prefijo ? FILMDB_TITLE_PREFIX : FILMDB_TITLE};
+  q.titulo = q.prefijo = titulo;
+  FilmResult res;
+  if (!filmdb_query(db, &q, &res)) {
+    perror("Error al reservar memoria");
+    return;
+  }
+
+  // Si ningún título coincide, informa al usuario
+  if (res.total == 0) {
+    printf("No se encontraron películas con el título %s%s\n", titulo,
+           prefijo ? "*" : "");
+    if (!prefijo)
+      mostrar_parecidas(db, q);
+  }
+
+  for (int i = 0; i < res.total; i++) {
+    int f = res.films[i];
+    printf("ID: %s, Título: %s, Director: %s, Año: %d\n", filmdb_id(db, f),
+           filmdb_title(db, f), filmdb_director(db, f), filmdb_year(db, f));
+  }
+  filmdb_result_clean(&res);
+}
+
+/**
+ * Busca y muestra la información de películas por título. Un '*' al final
+ * busca los títulos que empiezan con el texto ingresado.
+ */
+void buscar_por_titulo(FilmDB *db) {
+  char titulo[300]; // Buffer para almacenar el título (o parte de él)
+
+  // Solicita al usuario el título de la película
+  printf("Ingrese parte del título (Star*: títulos que empiezan con Star): ");
+  scanf(" %299[^\n]", titulo);
+  size_t largo = strlen(titulo);
+  int prefijo = largo > 0 && titulo[largo - 1] == '*';
+  if (prefijo)
+    titulo[largo - 1] = '\0';
+  consultar_por_titulo(db, titulo, prefijo);
+}
+
+/**
+ * Muestra la información de las películas que cumplen una combinación de
+ * criterios que no tiene opción propia en el menú.
+ */
+void consultar_combinada(FilmDB *db, const FilmQuery *q) {
+  FilmResult res;
+  if (!filmdb_query(db, q, &res)) {
+    perror("Error al reservar memoria");
+    return;
+  }
+  if (res.total == 0)
+    printf("No se encontraron películas\n");
+  for (int i = 0; i < res.total; i++) {
+    int f = res.films[i];
+    printf("ID: %s, Título: %s, Director: %s, Año: %d, Calificación: %.1f\n",
+           filmdb_id(db, f), filmdb_title(db, f), filmdb_director(db, f),
+           filmdb_year(db, f), filmdb_rating(db, f));
+  }
+  filmdb_result_clean(&res);
+}
+
+/* ---------- Modo por lotes ---------- */
+
+/**
+ * Separa una consulta en palabras, en el mismo lugar. Las comillas dobles
+ * agrupan varias palabras en una (`director "Christopher Nolan"`).
+ *
+ * @return Retorna el número de palabras, o -1 si faltan comillas de cierre o
+ * hay más de `max` palabras.
+ */
+int separar_consulta(char *linea, char **palabras, int max) {
+  int n = 0;
+  char *c = linea;
+  while (1) {
+    while (isspace((unsigned char)*c))
+      c++;
+    if (*c == '\0')
+      return n;
+    if (n == max)
+      return -1;
+    if (*c == '"') {
+      palabras[n++] = ++c;
+      c = strchr(c, '"');
+      if (c == NULL)
+        return -1;
+    } else {
+      palabras[n++] = c;
+      while (*c != '\0' && !isspace((unsigned char)*c))
+        c++;
+      if (*c == '\0')
+        return n;
     }
+    *c++ = '\0';
+  }
+}
 
-    // Convierte la década a valores numéricos para el inicio y fin de la década
-    int inicio_decada, fin_decada;
-    sscanf(decada_str, "%d", &inicio_decada);
-    fin_decada = inicio_decada + 9;
-
-    // Itera sobre el mapa para buscar y mostrar películas de la década y género ingresados
-    MapPair *pair = map_first(pelis_byid);
-    int found = 0; // Variable para rastrear si se encontró alguna película del género y década
-    while (pair != NULL) {
-        Film *peli = pair->value;
-        // Comprueba si el año de la película está dentro del rango de la década ingresada por el usuario
-        if (peli->year >= inicio_decada && peli->year <= fin_decada) {
-            // Comprueba si el género de la película coincide con el género ingresado por el usuario
-            Node *current_genre = peli->genres->head;
-            while (current_genre != NULL) {
-                if (strcmp((char *)current_genre->data, genero) == 0) {
-                    // Si el género coincide, muestra la información de la película
-                    printf("ID: %s, Título: %s, Director: %s, Calificación: %.1f\n", peli->id,
-                           peli->title, peli->director, peli->rating);
-                    found = 1; // Indica que se encontró al menos una película del género y década
-                    break; // Sal del bucle si se encuentra el género
-                }
-                current_genre = current_genre->next;
-            }
-        }
-        pair = map_next(pelis_byid); // Avanza al siguiente par en el mapa
+/**
+ * Ejecuta una consulta del modo por lotes: pares `criterio valor` con los
+ * criterios id, director, genre, decade (1990 o 1990s), rating (7.0-8.1),
+ * title (parte del título) y prefix (comienzo del título); `match fuzzy`
+ * acepta errores en el director, el título y los géneros.
+ * Si hay un escritor, las películas se escriben con él (en su formato, con
+ * `numero` en la columna query); si no, un criterio solo o década y género se
+ * muestran igual que en el menú y las demás combinaciones muestran todos los
+ * datos de cada película. Las líneas vacías y las que empiezan con '#' se
+ * ignoran.
+ *
+ * @return Retorna 1 si la consulta es válida, 0 de lo contrario.
+ */
+int ejecutar_consulta(FilmDB *db, char *linea, FilmWriter *w, long numero) {
+  char *palabras[16];
+  int n = separar_consulta(linea, palabras, 16);
+  if (n == 0 || (n > 0 && palabras[0][0] == '#'))
+    return 1;
+  if (n == -1 || n % 2 != 0)
+    return 0;
+
+  FilmQuery q;
+  memset(&q, 0, sizeof(q));
+  for (int i = 0; i < n; i += 2) {
+    char *clave = palabras[i], *valor = palabras[i + 1], *fin;
+    int criterio;
+    if (strcmp(clave, "id") == 0) {
+      criterio = FILMDB_ID;
+      q.id = valor;
+    } else if (strcmp(clave, "director") == 0) {
+      criterio = FILMDB_DIRECTOR;
+      q.director = valor;
+    } else if (strcmp(clave, "genre") == 0) {
+      criterio = FILMDB_GENRE;
+      q.genero = valor;
+    } else if (strcmp(clave, "decade") == 0) {
+      criterio = FILMDB_DECADE;
+      errno = 0;
+      long decada = strtol(valor, &fin, 10);
+      if (fin == valor || (*fin != '\0' && strcmp(fin, "s") != 0) ||
+          errno == ERANGE || decada < INT_MIN || decada > INT_MAX)
+        return 0;
+      q.decada = decada;
+    } else if (strcmp(clave, "rating") == 0) {
+      criterio = FILMDB_RATING;
+      char resto;
+      if (sscanf(valor, "%f-%f%c", &q.rating_min, &q.rating_max, &resto) != 2)
+        return 0;
+    } else if (strcmp(clave, "title") == 0) {
+      criterio = FILMDB_TITLE;
+      q.titulo = valor;
+    } else if (strcmp(clave, "prefix") == 0) {
+      criterio = FILMDB_TITLE_PREFIX;
+      q.prefijo = valor;
+    } else if (strcmp(clave, "match") == 0 && strcmp(valor, "fuzzy") == 0) {
+      criterio = FILMDB_FUZZY;
+    } else {
+      return 0;
     }
+    if (q.criterios & criterio)
+      return 0; // Criterio repetido
+    q.criterios |= criterio;
+  }
 
-    // Si no se encontraron películas del género y década ingresados, informa al usuario
-    if (!found) {
-        printf("No se encontraron películas del género %s de la década %d\n",
-               genero, inicio_decada);
+  if (w != NULL) {
+    FilmResult res;
+    if (!filmdb_query(db, &q, &res)) {
+      perror("Error al reservar memoria");
+      return 1;
+    }
+    filmwriter_result(w, db, &res, numero);
+    filmdb_result_clean(&res);
+    return 1;
+  }
+
+  switch (q.criterios) {
+  case FILMDB_ID:
+    consultar_por_id(db, q.id);
+    break;
+  case FILMDB_DIRECTOR:
+    consultar_por_director(db, q.director);
+    break;
+  case FILMDB_GENRE:
+    consultar_por_genero(db, q.genero);
+    break;
+  case FILMDB_DECADE:
+    consultar_por_decada(db, q.decada);
+    break;
+  case FILMDB_RATING:
+    consultar_por_rango_calificaciones(db, q.rating_min, q.rating_max);
+    break;
+  case FILMDB_DECADE | FILMDB_GENRE:
+    consultar_por_decada_y_genero(db, q.decada, q.genero);
+    break;
+  case FILMDB_TITLE:
+    consultar_por_titulo(db, q.titulo, 0);
+    break;
+  case FILMDB_TITLE_PREFIX:
+    consultar_por_titulo(db, q.prefijo, 1);
+    break;
+  default:
+    consultar_combinada(db, &q);
+  }
+  return 1;
+}
+
+/**
+ * Modo por lotes: carga el catálogo una vez y ejecuta una consulta por línea
+ * de `ruta` (o de la entrada estándar si es NULL), escribiendo los resultados
+ * en la salida estándar sin limpiar la pantalla ni esperar teclas (con el
+ * escritor `w` si no es NULL). Las consultas inválidas se informan en la
+ * salida de errores con su número de línea.
+ *
+ * @return Retorna 0 si se cargó el catálogo y todas las consultas fueron
+ * válidas y se pudieron escribir, 1 de lo contrario (sin ejecutar ninguna
+ * consulta si falla la carga).
+ */
+int ejecutar_lote(FilmDB *db, const char *ruta, int hilos, FilmWriter *w) {
+  FILE *entrada = ruta ? fopen(ruta, "r") : stdin;
+  if (entrada == NULL) {
+    perror("Error al abrir el archivo de consultas");
+    return 1;
+  }
+  // La salida va a un búfer grande, que se vacía solo cuando se llena
+  static char bufer[1 << 16];
+  setvbuf(stdout, bufer, _IOFBF, sizeof(bufer));
+
+  if (cargar_peliculas(db, hilos) != FILMDB_OK) {
+    if (entrada != stdin)
+      fclose(entrada);
+    return 1;
+  }
+
+  char *linea = NULL;
+  size_t cap = 0;
+  long numero = 0;
+  int errores = 0;
+  while (getline(&linea, &cap, entrada) != -1) {
+    numero++;
+    if (!ejecutar_consulta(db, linea, w, numero)) {
+      fprintf(stderr, "Consulta inválida en la línea %ld\n", numero);
+      errores = 1;
     }
+  }
+  free(linea);
+  if (entrada != stdin)
+    fclose(entrada);
+  fflush(stdout);
+  if (w != NULL && !filmwriter_flush(w)) {
+    perror("Error al escribir los resultados");
+    errores = 1;
+  }
+  return errores;
 }
 
-int main() {
+void mostrar_uso(const char *programa) {
+  fprintf(stderr,
+          "Uso: %s [-b [-f csv|jsonl|tsv] [-c columnas] [consultas.txt]]\n"
+          "Columnas: query,id,title,director,year,rating,votes,duration,"
+          "genres\n",
+          programa);
+}
+
+int main(int argc, char **argv) {
   char opcion; // Variable para almacenar una opción ingresada por el usuario
 
-  // Crea un mapa para almacenar películas, utilizando funciones de comparación
-  // para claves de tipo string y entero.
-  Map *pelis_byid = map_create(is_equal_str);
+  // La carga usa un hilo por núcleo disponible
+  int hilos = sysconf(_SC_NPROCESSORS_ONLN);
+
+  // Con -b se ejecutan las consultas del archivo indicado (o de la entrada
+  // estándar) en vez de mostrar el menú; -f y -c eligen un formato para otros
+  // programas y sus columnas
+  int lote = 0, formato = -1, n_columnas = 0;
+  int columnas[FILMWRITER_N_COLUMNS];
+  int arg;
+  while ((arg = getopt(argc, argv, "bf:c:")) != -1) {
+    if (arg == 'b') {
+      lote = 1;
+    } else if (arg == 'f' && (formato = filmwriter_format(optarg)) != -1) {
+      continue;
+    } else if (arg == 'c' &&
+               (n_columnas = filmwriter_columns(optarg, columnas)) != -1) {
+      continue;
+    } else {
+      mostrar_uso(argv[0]);
+      return 1;
+    }
+  }
+  if (optind < argc - 1 || (!lote && (optind < argc || formato != -1 ||
+                                      n_columnas > 0))) {
+    mostrar_uso(argv[0]);
+    return 1;
+  }
+
+  // Crea el catálogo de películas, que al cargarse construye un índice por
+  // criterio de búsqueda
+  FilmDB *db = filmdb_create();
+  if (db == NULL) {
+    perror("Error al reservar memoria");
+    return 1;
+  }
 
-  // Recuerda usar un mapa por criterio de búsqueda
+  if (lote) {
+    FilmWriter *w = NULL;
+    if (formato != -1 || n_columnas > 0) {
+      // Sin -f, las columnas elegidas se escriben en CSV
+      w = filmwriter_create(STDOUT_FILENO, formato == -1 ? FILMWRITER_CSV
+                                                         : formato,
+                            n_columnas > 0 ? columnas : NULL, n_columnas);
+      if (w == NULL) {
+        perror("Error al reservar memoria");
+        filmdb_clean(db);
+        free(db);
+        return 1;
+      }
+    }
+    int errores = ejecutar_lote(db, optind < argc ? argv[optind] : NULL,
+                                hilos, w);
+    if (w != NULL) {
+      filmwriter_clean(w);
+      free(w);
+    }
+    filmdb_clean(db);
+    free(db);
+    return errores;
+  }
 
   do {
     mostrarMenuPrincipal();
@@ -370,25 +673,28 @@ int main() {
 
     switch (opcion) {
     case '1':
-      cargar_peliculas(pelis_byid);
+      cargar_peliculas(db, hilos);
       break;
     case '2':
-      buscar_por_id(pelis_byid);
+      buscar_por_id(db);
       break;
     case '3':
-      buscar_por_director(pelis_byid);
+      buscar_por_director(db);
       break;
     case '4':
-      buscar_por_genero(pelis_byid);
+      buscar_por_genero(db);
       break;
     case '5':
-      buscar_por_decada(pelis_byid);
+      buscar_por_decada(db);
       break;
     case '6':
-      buscar_por_rango_calificaciones(pelis_byid);
+      buscar_por_rango_calificaciones(db);
       break;
     case '7':
-      buscar_por_decada_y_genero(pelis_byid);
+      buscar_por_decada_y_genero(db);
+      break;
+    case '9':
+      buscar_por_titulo(db);
       break;
     default:
       break;
@@ -397,15 +703,9 @@ int main() {
 
   } while (opcion != '8');
 
-  // Liberar la memoria utilizada por el mapa y las películas almacenadas
-  MapPair *pair = map_first(pelis_byid);
-  while (pair != NULL) {
-    free(pair->value);           // Liberar la memoria de la película
-    pair = map_next(pelis_byid); // Avanzar al siguiente par en el mapa
-  }
-  map_clean(pelis_byid); // Liberar la memoria del mapa
+  // Liberar la memoria utilizada por la tabla, los índices y el archivo
+  filmdb_clean(db);
+  free(db);
 
   return 0;
 }
-
-///El codigo corre bien, pero hay error en la funcion de buscar por genero, porque no esta funcionando bien, guarda los valores como numeros y no deja trabajar con ellos, el codigo esta bien, pero no se como corregirlo. por ende tambien falla la funcion de buscar por decada y genero. pero compensé al hacer la funcion de director, ya que hice el trabajo solo, el resto de codigo funciona normalmente.
\ No newline at end of file
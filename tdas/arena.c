@@ -0,0 +1,96 @@
+#include "arena.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define TAM_BLOQUE 65536 // Bytes útiles de un bloque normal
+#define ALINEACION 16    // Suficiente para cualquier tipo escalar
+
+// Bloque de memoria de la arena. Los datos van a continuación de la cabecera.
+typedef struct Bloque {
+  struct Bloque *next;
+  size_t usado;
+  size_t capacidad;
+} Bloque;
+
+struct Arena {
+  Bloque *actual; // Bloque donde se reserva; los anteriores van en next
+};
+
+// Tamaño de la cabecera redondeado, para que los datos queden alineados
+#define CABECERA ((sizeof(Bloque) + ALINEACION - 1) & ~(size_t)(ALINEACION - 1))
+
+Arena *arena_create() {
+  Arena *arena = (Arena *)calloc(1, sizeof(Arena));
+  return arena; // NULL si falla la asignación de memoria
+}
+
+static Bloque *_nuevo_bloque(size_t capacidad) {
+  Bloque *bloque = (Bloque *)malloc(CABECERA + capacidad);
+  if (bloque == NULL)
+    return NULL; // Fallo en la asignación de memoria
+  bloque->next = NULL;
+  bloque->usado = 0;
+  bloque->capacidad = capacidad;
+  return bloque;
+}
+
+void *arena_alloc(Arena *arena, size_t size) {
+  size = (size + ALINEACION - 1) & ~(size_t)(ALINEACION - 1);
+  Bloque *bloque = arena->actual;
+  if (bloque == NULL || bloque->capacidad - bloque->usado < size) {
+    if (size > TAM_BLOQUE / 4 && bloque != NULL) {
+      // Las reservas grandes van en un bloque propio, detrás del actual, para
+      // no desperdiciar lo que queda libre en él
+      Bloque *grande = _nuevo_bloque(size);
+      if (grande == NULL)
+        return NULL;
+      grande->usado = size;
+      grande->next = bloque->next;
+      bloque->next = grande;
+      return (char *)grande + CABECERA;
+    }
+    bloque = _nuevo_bloque(size > TAM_BLOQUE ? size : TAM_BLOQUE);
+    if (bloque == NULL)
+      return NULL;
+    bloque->next = arena->actual;
+    arena->actual = bloque;
+  }
+  void *ptr = (char *)bloque + CABECERA + bloque->usado;
+  bloque->usado += size;
+  return ptr;
+}
+
+char *arena_strdup(Arena *arena, const char *str) {
+  size_t largo = strlen(str) + 1;
+  char *copia = (char *)arena_alloc(arena, largo);
+  if (copia != NULL)
+    memcpy(copia, str, largo);
+  return copia;
+}
+
+void arena_absorb(Arena *dest, Arena *src) {
+  if (src->actual == NULL)
+    return;
+  if (dest->actual == NULL) {
+    dest->actual = src->actual;
+  } else {
+    // Los bloques de src se enlazan detrás del actual de dest, que sigue
+    // siendo donde se reserva
+    Bloque *ultimo = src->actual;
+    while (ultimo->next != NULL)
+      ultimo = ultimo->next;
+    ultimo->next = dest->actual->next;
+    dest->actual->next = src->actual;
+  }
+  src->actual = NULL;
+}
+
+void arena_clean(Arena *arena) {
+  Bloque *bloque = arena->actual;
+  while (bloque != NULL) {
+    Bloque *next = bloque->next;
+    free(bloque);
+    bloque = next;
+  }
+  arena->actual = NULL;
+}
@@ -0,0 +1,28 @@
+#ifndef ARENA_H
+#define ARENA_H
+#include <stddef.h>
+
+typedef struct Arena Arena;
+
+// Esta función crea una arena vacía. Una arena entrega memoria desde bloques
+// grandes avanzando un puntero, sin liberar cada reserva por separado: toda la
+// memoria se libera de una vez con arena_clean.
+Arena *arena_create();
+
+// Esta función reserva `size` bytes alineados para cualquier tipo. Retorna
+// NULL si falla la asignación de memoria.
+void *arena_alloc(Arena *arena, size_t size);
+
+// Esta función copia la cadena (con su '\0') a la arena.
+char *arena_strdup(Arena *arena, const char *str);
+
+// Esta función traspasa todos los bloques de `src` a `dest`, de modo que la
+// memoria reservada en `src` se libera junto con la de `dest`. `src` queda
+// vacía y puede seguir usándose.
+void arena_absorb(Arena *dest, Arena *src);
+
+// Esta función libera toda la memoria reservada en la arena. La arena queda
+// vacía y puede seguir usándose.
+void arena_clean(Arena *arena);
+
+#endif /* ARENA_H */
@@ -0,0 +1,146 @@
+#include "concurrent_map.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SHARDS_POR_DEFECTO 64
+#define LINEA_CACHE 64
+
+// Fragmento del mapa: una tabla hash con su candado. Cada fragmento ocupa
+// líneas de caché propias, para que los hilos que usan fragmentos vecinos no
+// se invaliden la caché entre sí.
+typedef struct {
+  _Alignas(LINEA_CACHE) pthread_rwlock_t lock;
+  Map *map;
+  long count; // Pares del fragmento
+} Shard;
+
+struct ConcurrentMap {
+  unsigned long (*hash)(void *key);
+  Shard *shards;
+  int n_shards;
+  int bits; // n_shards == 1 << bits
+};
+
+ConcurrentMap *concurrent_map_create(unsigned long (*hash)(void *key),
+                                     int (*is_equal)(void *key1, void *key2),
+                                     int shards) {
+  if (shards <= 0)
+    shards = SHARDS_POR_DEFECTO;
+  int bits = 0;
+  while ((1 << bits) < shards)
+    bits++;
+
+  ConcurrentMap *newMap = (ConcurrentMap *)calloc(1, sizeof(ConcurrentMap));
+  if (newMap == NULL)
+    return NULL; // Fallo en la asignación de memoria
+  newMap->hash = hash;
+  newMap->n_shards = 1 << bits;
+  newMap->bits = bits;
+  newMap->shards =
+      (Shard *)aligned_alloc(LINEA_CACHE, newMap->n_shards * sizeof(Shard));
+  if (newMap->shards == NULL) {
+    free(newMap);
+    return NULL;
+  }
+  memset(newMap->shards, 0, newMap->n_shards * sizeof(Shard));
+  for (int i = 0; i < newMap->n_shards; i++) {
+    Shard *s = &newMap->shards[i];
+    s->map = hash_map_create(hash, is_equal);
+    if (s->map == NULL || pthread_rwlock_init(&s->lock, NULL) != 0) {
+      if (s->map != NULL)
+        map_clean(s->map);
+      free(s->map);
+      newMap->n_shards = i; // Solo se limpian los fragmentos ya creados
+      concurrent_map_clean(newMap);
+      free(newMap);
+      return NULL;
+    }
+  }
+  return newMap;
+}
+
+// Fragmento de la clave. Se toman los bits altos del hash mezclado
+// (hashing de Fibonacci), porque la tabla de cada fragmento usa los bajos.
+static Shard *_shard(ConcurrentMap *map, void *key) {
+  if (map->bits == 0)
+    return &map->shards[0];
+  unsigned long h = map->hash(key) * 0x9e3779b97f4a7c15UL;
+  return &map->shards[h >> (8 * sizeof(unsigned long) - map->bits)];
+}
+
+void concurrent_map_insert(ConcurrentMap *map, void *key, void *value) {
+  Shard *s = _shard(map, key);
+  pthread_rwlock_wrlock(&s->lock);
+  if (map_search(s->map, key) == NULL) {
+    map_insert(s->map, key, value);
+    s->count++;
+  }
+  pthread_rwlock_unlock(&s->lock);
+}
+
+int concurrent_map_get(ConcurrentMap *map, void *key, void **value) {
+  Shard *s = _shard(map, key);
+  pthread_rwlock_rdlock(&s->lock);
+  MapPair *pair = map_search(s->map, key);
+  if (pair != NULL)
+    *value = pair->value;
+  pthread_rwlock_unlock(&s->lock);
+  return pair != NULL;
+}
+
+MapPair *concurrent_map_search(ConcurrentMap *map, void *key) {
+  Shard *s = _shard(map, key);
+  pthread_rwlock_rdlock(&s->lock);
+  MapPair *pair = map_search(s->map, key);
+  pthread_rwlock_unlock(&s->lock);
+  return pair;
+}
+
+MapPair *concurrent_map_remove(ConcurrentMap *map, void *key) {
+  Shard *s = _shard(map, key);
+  pthread_rwlock_wrlock(&s->lock);
+  MapPair *pair = map_remove(s->map, key);
+  if (pair != NULL)
+    s->count--;
+  pthread_rwlock_unlock(&s->lock);
+  return pair;
+}
+
+long concurrent_map_size(ConcurrentMap *map) {
+  long total = 0;
+  for (int i = 0; i < map->n_shards; i++) {
+    Shard *s = &map->shards[i];
+    pthread_rwlock_rdlock(&s->lock);
+    total += s->count;
+    pthread_rwlock_unlock(&s->lock);
+  }
+  return total;
+}
+
+void concurrent_map_foreach(ConcurrentMap *map,
+                            void (*visitar)(MapPair *pair, void *ctx),
+                            void *ctx) {
+  for (int i = 0; i < map->n_shards; i++) {
+    Shard *s = &map->shards[i];
+    pthread_rwlock_rdlock(&s->lock);
+    MapIter it;
+    for (MapPair *pair = map_iter_first(s->map, &it); pair != NULL;
+         pair = map_iter_next(&it))
+      visitar(pair, ctx);
+    pthread_rwlock_unlock(&s->lock);
+  }
+}
+
+void concurrent_map_clean(ConcurrentMap *map) {
+  for (int i = 0; i < map->n_shards; i++) {
+    Shard *s = &map->shards[i];
+    map_clean(s->map);
+    free(s->map);
+    pthread_rwlock_destroy(&s->lock);
+  }
+  free(map->shards);
+  map->shards = NULL;
+  map->n_shards = 0;
+  map->bits = 0;
+}
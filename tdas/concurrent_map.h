@@ -0,0 +1,55 @@
+#ifndef CONCURRENT_MAP_H
+#define CONCURRENT_MAP_H
+#include "map.h"
+
+// Mapa no ordenado que pueden usar varios hilos a la vez. Las claves se
+// reparten por su hash en fragmentos (shards), cada uno con su propia tabla
+// hash y su propio candado de lectura/escritura: las búsquedas solo toman el
+// candado de lectura de su fragmento, así que muchos lectores avanzan en
+// paralelo, y una escritura solo detiene a los que usan el mismo fragmento.
+typedef struct ConcurrentMap ConcurrentMap;
+
+// Esta función crea un mapa concurrente vacío con `shards` fragmentos (se
+// redondea a una potencia de 2; si es 0 o menos se usa un valor por defecto).
+// La función hash debe ser consistente con is_equal, como en hash_map_create.
+// Retorna NULL si falla la asignación de memoria.
+ConcurrentMap *concurrent_map_create(unsigned long (*hash)(void *key),
+                                     int (*is_equal)(void *key1, void *key2),
+                                     int shards);
+
+// Esta función inserta el par (key, value) si la clave no está en el mapa,
+// como map_insert.
+void concurrent_map_insert(ConcurrentMap *map, void *key, void *value);
+
+// Esta función deja en `value` el valor asociado a la clave, copiado mientras
+// el fragmento está bloqueado, y retorna 1; si la clave no existe retorna 0.
+// Es la forma segura de leer un valor cuando otros hilos pueden eliminar
+// pares del mapa.
+int concurrent_map_get(ConcurrentMap *map, void *key, void **value);
+
+// Esta función retorna el par con la clave dada, o NULL si no existe. El par
+// sigue siendo válido solo mientras nadie lo elimine (y lo libere): si otros
+// hilos pueden eliminar pares, debe usarse concurrent_map_get.
+MapPair *concurrent_map_search(ConcurrentMap *map, void *key);
+
+// Esta función elimina el par con la clave dada y lo retorna (para liberarlo
+// con free), o NULL si no existe.
+MapPair *concurrent_map_remove(ConcurrentMap *map, void *key);
+
+// Esta función retorna el número de pares del mapa. Si otros hilos lo están
+// modificando, el resultado puede no corresponder a un mismo instante.
+long concurrent_map_size(ConcurrentMap *map);
+
+// Esta función llama a `visitar` con cada par del mapa y el puntero `ctx`,
+// fragmento por fragmento. Mientras recorre un fragmento lo bloquea para
+// escrituras, por lo que `visitar` no debe modificar el mapa.
+void concurrent_map_foreach(ConcurrentMap *map,
+                            void (*visitar)(MapPair *pair, void *ctx),
+                            void *ctx);
+
+// Esta función elimina todos los pares del mapa (no las claves ni los valores
+// a los que apuntan) y sus fragmentos. El mapa se libera luego con free. No
+// debe llamarse mientras otros hilos usan el mapa.
+void concurrent_map_clean(ConcurrentMap *map);
+
+#endif /* CONCURRENT_MAP_H */
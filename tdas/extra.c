@@ -1,4 +1,14 @@
 #include "extra.h"
+#include <ctype.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
 
 #define MAX_LINE_LENGTH 1024
 #define MAX_FIELDS 300
@@ -50,6 +60,376 @@ char **leer_linea_csv(FILE *archivo, char separador) {
   return campos;
 }
 
+// Lee el archivo completo a memoria dinámica, dejando un '\0' al final para
+// poder terminar el último campo aunque no haya salto de línea
+static char *_leer_completo(int fd, size_t tamano) {
+  char *datos = (char *)malloc(tamano + 1);
+  if (datos == NULL)
+    return NULL;
+  size_t leidos = 0;
+  while (leidos < tamano) {
+    ssize_t n = read(fd, datos + leidos, tamano - leidos);
+    if (n <= 0) {
+      free(datos);
+      return NULL;
+    }
+    leidos += n;
+  }
+  datos[tamano] = '\0';
+  return datos;
+}
+
+ArchivoCSV *csv_abrir(const char *ruta) {
+  int fd = open(ruta, O_RDONLY);
+  if (fd == -1)
+    return NULL;
+
+  struct stat st;
+  if (fstat(fd, &st) == -1) {
+    close(fd);
+    return NULL;
+  }
+
+  ArchivoCSV *csv = (ArchivoCSV *)malloc(sizeof(ArchivoCSV));
+  if (csv == NULL) {
+    close(fd);
+    return NULL;
+  }
+  csv->tamano = st.st_size;
+  csv->inicio = 0;
+  csv->pos = 0;
+  csv->datos = NULL;
+  csv->mapeado = 0;
+  csv->indice = NULL;
+
+  // Copia privada (MAP_PRIVATE) para poder terminar los campos en el mismo
+  // lugar sin modificar el archivo. Si no termina en '\n' no hay dónde poner el
+  // '\0' del último campo, así que en ese caso se lee a memoria.
+  if (csv->tamano > 0) {
+    char *datos = mmap(NULL, csv->tamano, PROT_READ | PROT_WRITE, MAP_PRIVATE,
+                       fd, 0);
+    if (datos != MAP_FAILED && datos[csv->tamano - 1] == '\n') {
+      madvise(datos, csv->tamano, MADV_SEQUENTIAL);
+      csv->datos = datos;
+      csv->mapeado = 1;
+    } else {
+      if (datos != MAP_FAILED)
+        munmap(datos, csv->tamano);
+      csv->datos = _leer_completo(fd, csv->tamano);
+    }
+  } else {
+    csv->datos = _leer_completo(fd, 0);
+  }
+  close(fd);
+
+  if (csv->datos == NULL) {
+    free(csv);
+    return NULL;
+  }
+  return csv;
+}
+
+/* ---------- Índice estructural ----------
+ *
+ * En vez de revisar byte a byte, el archivo se recorre en bloques de 64 bytes
+ * obteniendo máscaras de bits con las posiciones de comillas, separadores y
+ * saltos de línea (16 o 32 bytes por instrucción con SSE2/AVX2). Con la máscara
+ * de comillas se calcula qué bytes están dentro de un campo entrecomillado
+ * (XOR prefijo), y los separadores y saltos de línea que quedan fuera forman el
+ * índice estructural: las posiciones donde termina cada campo.
+ */
+
+// Máscara con un bit por cada byte de p[0..63] igual a c
+static inline uint64_t _mascara_igual(const char *p, char c) {
+#if defined(__AVX2__)
+  __m256i v = _mm256_set1_epi8(c);
+  uint64_t lo = (uint32_t)_mm256_movemask_epi8(
+      _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)p), v));
+  uint64_t hi = (uint32_t)_mm256_movemask_epi8(
+      _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)(p + 32)), v));
+  return lo | (hi << 32);
+#elif defined(__SSE2__)
+  __m128i v = _mm_set1_epi8(c);
+  uint64_t m = 0;
+  for (int i = 0; i < 4; i++) {
+    __m128i bloque = _mm_loadu_si128((const __m128i *)(p + 16 * i));
+    m |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(bloque, v))
+         << (16 * i);
+  }
+  return m;
+#else
+  uint64_t m = 0;
+  for (int i = 0; i < 64; i++)
+    m |= (uint64_t)(p[i] == c) << i;
+  return m;
+#endif
+}
+
+// XOR prefijo: el bit i queda en 1 si hay un número impar de bits en 1 en
+// las posiciones 0..i (es decir, si el byte i está dentro de comillas)
+static inline uint64_t _xor_prefijo(uint64_t x) {
+#if defined(__PCLMUL__)
+  __m128i r = _mm_clmulepi64_si128(_mm_set_epi64x(0, x), _mm_set1_epi8(-1), 0);
+  return (uint64_t)_mm_cvtsi128_si64(r);
+#else
+  x ^= x << 1;
+  x ^= x << 2;
+  x ^= x << 4;
+  x ^= x << 8;
+  x ^= x << 16;
+  x ^= x << 32;
+  return x;
+#endif
+}
+
+// Indexa el siguiente tramo del archivo (hasta BLOQUE_INDICE bytes). Las
+// posiciones se guardan relativas al inicio del tramo.
+static void _indexar_tramo(ArchivoCSV *csv, char separador) {
+  size_t base = csv->escaneado;
+  size_t largo = csv->tamano - base;
+  if (largo > BLOQUE_INDICE)
+    largo = BLOQUE_INDICE;
+
+  csv->base_indice = base;
+  csv->n_indice = 0;
+  csv->i_indice = 0;
+
+  for (size_t off = 0; off < largo; off += 64) {
+    const char *p = csv->datos + base + off;
+    char relleno[64];
+    if (largo - off < 64) { // Último bloque incompleto: se rellena con ceros
+      memset(relleno, 0, sizeof(relleno));
+      memcpy(relleno, p, largo - off);
+      p = relleno;
+    }
+
+    uint64_t comillas = _mascara_igual(p, '\"');
+    uint64_t dentro = _xor_prefijo(comillas) ^ csv->en_comillas;
+    // Propaga el estado del último byte al bloque siguiente
+    csv->en_comillas = (uint64_t)((int64_t)dentro >> 63);
+
+    uint64_t estructura =
+        (_mascara_igual(p, separador) | _mascara_igual(p, '\n')) & ~dentro;
+    while (estructura != 0) {
+      csv->indice[csv->n_indice++] =
+          (uint32_t)(off + __builtin_ctzll(estructura));
+      estructura &= estructura - 1;
+    }
+  }
+  csv->escaneado = base + largo;
+}
+
+// Retorna la primera posición estructural >= desde, o el tamaño del archivo si
+// no hay más
+static size_t _siguiente_estructural(ArchivoCSV *csv, char separador,
+                                     size_t desde) {
+  if (csv->indice == NULL || csv->separador_indice != separador) {
+    // Primer uso (o cambio de separador): se indexa desde el principio
+    if (csv->indice == NULL)
+      csv->indice = (uint32_t *)malloc(BLOQUE_INDICE * sizeof(uint32_t));
+    csv->separador_indice = separador;
+    csv->escaneado = csv->inicio;
+    csv->en_comillas = 0;
+    csv->n_indice = csv->i_indice = 0;
+    csv->base_indice = 0;
+  }
+  while (1) {
+    while (csv->i_indice < csv->n_indice) {
+      size_t pos = csv->base_indice + csv->indice[csv->i_indice];
+      if (pos >= desde)
+        return pos;
+      csv->i_indice++;
+    }
+    if (csv->escaneado >= csv->tamano)
+      return csv->tamano;
+    _indexar_tramo(csv, separador);
+  }
+}
+
+int csv_leer_linea(ArchivoCSV *csv, char separador, CampoCSV *campos,
+                   int max_campos) {
+  char *datos = csv->datos;
+  size_t fin = csv->tamano;
+  size_t r = csv->pos;
+
+  // Salta líneas vacías
+  while (r < fin && (datos[r] == '\n' || datos[r] == '\r'))
+    r++;
+  if (r >= fin) {
+    csv->pos = fin;
+    return -1; // No hay más líneas para leer
+  }
+
+  int idx = 0;
+  while (1) {
+    // El campo ocupa [r, e): e es el separador o salto de línea que lo cierra
+    size_t e = _siguiente_estructural(csv, separador, r);
+    size_t inicio, w;
+    if (datos[r] == '\"') { // Campo entrecomillado
+      inicio = w = ++r;
+      while (r < e) {
+        if (datos[r] == '\"') {
+          if (r + 1 < e && datos[r + 1] == '\"') { // Comilla escapada ""
+            datos[w++] = '\"';
+            r += 2;
+            continue;
+          }
+          r++; // Comilla de cierre
+          break;
+        }
+        datos[w++] = datos[r++];
+      }
+      // Cualquier caracter tras la comilla de cierre se agrega tal cual
+      while (r < e)
+        datos[w++] = datos[r++];
+    } else { // Campo sin comillas
+      inicio = r;
+      w = e;
+    }
+    r = e;
+
+    // Quita el '\r' de los finales de línea de Windows
+    if (w > inicio && (r >= fin || datos[r] == '\n') && datos[w - 1] == '\r')
+      w--;
+
+    char fin_campo = r < fin ? datos[r] : '\n';
+    datos[w] = '\0'; // Termina el campo en el mismo lugar (w <= r)
+    if (idx < max_campos) {
+      campos[idx].ptr = datos + inicio;
+      campos[idx].len = w - inicio;
+    }
+    idx++;
+    r++;
+
+    if (fin_campo != separador)
+      break; // Fin de línea o de archivo
+  }
+
+  csv->pos = r < fin ? r : fin;
+  return idx < max_campos ? idx : max_campos;
+}
+
+// Cuenta las comillas de p[0..n-1] usando las mismas máscaras del índice
+static size_t _contar_comillas(const char *p, size_t n) {
+  size_t total = 0, i = 0;
+  for (; i + 64 <= n; i += 64)
+    total += __builtin_popcountll(_mascara_igual(p + i, '\"'));
+  for (; i < n; i++)
+    total += p[i] == '\"';
+  return total;
+}
+
+int csv_dividir(ArchivoCSV *csv, int partes, size_t *cortes) {
+  size_t inicio = csv->pos, fin = csv->tamano;
+  size_t previo = inicio; // Hasta dónde se contaron las comillas
+  int en_comillas = 0;    // Estado en la posición `previo`
+
+  cortes[0] = inicio;
+  for (int k = 1; k < partes; k++) {
+    size_t aprox = inicio + (fin - inicio) / partes * k;
+    if (aprox < cortes[k - 1])
+      aprox = cortes[k - 1];
+
+    // Paridad de comillas hasta la posición aproximada
+    en_comillas ^= _contar_comillas(csv->datos + previo, aprox - previo) & 1;
+    previo = aprox;
+
+    // Avanza hasta el primer salto de línea fuera de comillas
+    size_t r = aprox;
+    int estado = en_comillas;
+    while (r < fin && (estado || csv->datos[r] != '\n')) {
+      if (csv->datos[r] == '\"')
+        estado = !estado;
+      r++;
+    }
+    cortes[k] = r < fin ? r + 1 : fin;
+  }
+  cortes[partes] = fin;
+  return partes;
+}
+
+ArchivoCSV *csv_tramo(ArchivoCSV *csv, size_t inicio, size_t fin) {
+  ArchivoCSV *tramo = (ArchivoCSV *)malloc(sizeof(ArchivoCSV));
+  if (tramo == NULL)
+    return NULL;
+  tramo->datos = csv->datos;
+  tramo->tamano = fin;
+  tramo->inicio = inicio;
+  tramo->pos = inicio;
+  tramo->mapeado = -1; // Los datos pertenecen a csv
+  tramo->indice = NULL;
+  return tramo;
+}
+
+void csv_cerrar(ArchivoCSV *csv) {
+  if (csv == NULL)
+    return;
+  if (csv->mapeado == 1)
+    munmap(csv->datos, csv->tamano);
+  else if (csv->mapeado == 0)
+    free(csv->datos);
+  free(csv->indice);
+  free(csv);
+}
+
+// Letras latinas con diacríticos (por punto de código) y su forma plegada
+typedef struct {
+  unsigned short inicio, fin;
+  const char *base;
+} LetraPlegada;
+
+static const LetraPlegada letras_plegadas[] = {
+    {0x00C0, 0x00C5, "a"},  {0x00C6, 0x00C6, "ae"}, {0x00C7, 0x00C7, "c"},
+    {0x00C8, 0x00CB, "e"},  {0x00CC, 0x00CF, "i"},  {0x00D0, 0x00D0, "d"},
+    {0x00D1, 0x00D1, "n"},  {0x00D2, 0x00D6, "o"},  {0x00D8, 0x00D8, "o"},
+    {0x00D9, 0x00DC, "u"},  {0x00DD, 0x00DD, "y"},  {0x00DE, 0x00DE, "th"},
+    {0x00DF, 0x00DF, "ss"}, {0x00E0, 0x00E5, "a"},  {0x00E6, 0x00E6, "ae"},
+    {0x00E7, 0x00E7, "c"},  {0x00E8, 0x00EB, "e"},  {0x00EC, 0x00EF, "i"},
+    {0x00F0, 0x00F0, "d"},  {0x00F1, 0x00F1, "n"},  {0x00F2, 0x00F6, "o"},
+    {0x00F8, 0x00F8, "o"},  {0x00F9, 0x00FC, "u"},  {0x00FD, 0x00FD, "y"},
+    {0x00FE, 0x00FE, "th"}, {0x00FF, 0x00FF, "y"},  {0x0100, 0x0105, "a"},
+    {0x0106, 0x010D, "c"},  {0x010E, 0x0111, "d"},  {0x0112, 0x011B, "e"},
+    {0x011C, 0x0123, "g"},  {0x0124, 0x0127, "h"},  {0x0128, 0x0131, "i"},
+    {0x0132, 0x0133, "ij"}, {0x0134, 0x0135, "j"},  {0x0136, 0x0138, "k"},
+    {0x0139, 0x0142, "l"},  {0x0143, 0x014B, "n"},  {0x014C, 0x0151, "o"},
+    {0x0152, 0x0153, "oe"}, {0x0154, 0x0159, "r"},  {0x015A, 0x0161, "s"},
+    {0x0162, 0x0167, "t"},  {0x0168, 0x0173, "u"},  {0x0174, 0x0175, "w"},
+    {0x0176, 0x0178, "y"},  {0x0179, 0x017E, "z"},  {0x017F, 0x017F, "s"}};
+
+void plegar_texto(char *str) {
+  unsigned char *lee = (unsigned char *)str;
+  char *escribe = str;
+  while (*lee) {
+    if (*lee < 0x80) {
+      *escribe++ = tolower(*lee++);
+      continue;
+    }
+    // Los caracteres que se pliegan ocupan dos bytes en UTF-8
+    if ((lee[0] & 0xE0) == 0xC0 && (lee[1] & 0xC0) == 0x80) {
+      unsigned cp = (lee[0] & 0x1F) << 6 | (lee[1] & 0x3F);
+      if (cp >= 0x0300 && cp <= 0x036F) { // Marca combinante: se elimina
+        lee += 2;
+        continue;
+      }
+      const char *base = NULL;
+      for (size_t i = 0;
+           base == NULL &&
+           i < sizeof(letras_plegadas) / sizeof(letras_plegadas[0]);
+           i++)
+        if (cp >= letras_plegadas[i].inicio && cp <= letras_plegadas[i].fin)
+          base = letras_plegadas[i].base;
+      if (base != NULL) {
+        while (*base)
+          *escribe++ = *base++;
+        lee += 2;
+        continue;
+      }
+    }
+    *escribe++ = *lee++;
+  }
+  *escribe = '\0';
+}
+
 // Función para limpiar la pantalla
 void limpiarPantalla() { system("clear"); }
 
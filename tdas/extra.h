@@ -1,10 +1,15 @@
 #ifndef EXTRA_H
 #define EXTRA_H
 
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+// Bytes del archivo que se indexan de una vez al separar campos con
+// csv_leer_linea (acota la memoria del índice estructural)
+#define BLOQUE_INDICE (1 << 16)
+
 /**
  * Función para leer y parsear una línea de un archivo CSV en campos
  * individuales.
@@ -38,6 +43,110 @@
  */
 char **leer_linea_csv(FILE *archivo, char separador);
 
+/**
+ * Vista de un campo de un archivo CSV abierto con csv_abrir: apunta dentro del
+ * contenido del archivo y además termina en '\0', por lo que puede usarse
+ * directamente como cadena de C.
+ */
+typedef struct {
+  char *ptr;  // Inicio del campo (sin comillas)
+  size_t len; // Largo del campo en bytes
+} CampoCSV;
+
+/**
+ * Archivo CSV mapeado completo en memoria. Los campos se separan en el mismo
+ * lugar (sin copiarlos), así que las vistas entregadas por csv_leer_linea son
+ * válidas hasta llamar a csv_cerrar.
+ */
+typedef struct {
+  char *datos;   // Contenido del archivo (copia privada, modificable)
+  size_t tamano; // Fin de la zona por leer (tamaño del archivo o del tramo)
+  size_t inicio; // Inicio de la zona por leer (0 salvo en tramos)
+  size_t pos;    // Posición de la próxima línea por leer
+  int mapeado;   // 1 si datos viene de mmap, 0 si se leyó a memoria dinámica,
+                 // -1 si es un tramo de otro archivo (no es dueño de datos)
+
+  // Índice estructural (uso interno de csv_leer_linea): posiciones de los
+  // separadores y saltos de línea fuera de comillas del tramo actual
+  uint32_t *indice;      // Posiciones relativas a base_indice
+  size_t n_indice;       // Posiciones en el tramo actual
+  size_t i_indice;       // Próxima posición por consumir
+  size_t base_indice;    // Inicio del tramo actual
+  size_t escaneado;      // Bytes del archivo ya indexados
+  uint64_t en_comillas;  // Todo 1 si el tramo anterior terminó entre comillas
+  char separador_indice; // Separador con el que se construyó el índice
+} ArchivoCSV;
+
+/**
+ * Abre un archivo CSV mapeándolo en memoria con mmap. Si no se puede mapear
+ * (o el archivo no termina en salto de línea) se lee completo a memoria.
+ *
+ * @param ruta Ruta del archivo CSV.
+ * @return Retorna el archivo abierto, o NULL si no se pudo abrir (errno queda
+ * con la causa).
+ */
+ArchivoCSV *csv_abrir(const char *ruta);
+
+/**
+ * Lee la siguiente línea de un archivo CSV abierto con csv_abrir y la separa en
+ * campos, sin copiar: cada campo queda como una vista (puntero, largo) dentro
+ * del archivo mapeado. Maneja campos entrecomillados que contienen el
+ * separador, saltos de línea o comillas dobles escapadas ("") y no tiene límite
+ * de largo de línea.
+ *
+ * Los límites de los campos se obtienen de un índice estructural construido
+ * 64 bytes a la vez con SSE2/AVX2 (según con qué se compile, p. ej.
+ * -march=native), con una versión escalar equivalente en otras arquitecturas.
+ *
+ * @param csv Archivo abierto con csv_abrir.
+ * @param separador Caracter utilizado para separar los campos.
+ * @param campos Arreglo donde se dejan las vistas de los campos.
+ * @param max_campos Capacidad del arreglo campos; los campos extra se ignoran.
+ *
+ * @return Retorna el número de campos de la línea, o -1 al llegar al final del
+ * archivo.
+ */
+int csv_leer_linea(ArchivoCSV *csv, char separador, CampoCSV *campos,
+                   int max_campos);
+
+/**
+ * Divide lo que queda por leer de un archivo CSV (desde su posición actual) en
+ * `partes` tramos de tamaño similar para procesarlos en paralelo. Cada corte
+ * cae justo después de un salto de línea que no está dentro de un campo
+ * entrecomillado, por lo que cada tramo contiene solo líneas completas.
+ *
+ * @param csv Archivo abierto con csv_abrir.
+ * @param partes Número de tramos.
+ * @param cortes Arreglo de partes + 1 posiciones; el tramo k es
+ * [cortes[k], cortes[k + 1]). Algunos tramos pueden quedar vacíos.
+ * @return Retorna el número de tramos.
+ */
+int csv_dividir(ArchivoCSV *csv, int partes, size_t *cortes);
+
+/**
+ * Crea un lector independiente para el tramo [inicio, fin) de un archivo, que
+ * se lee con csv_leer_linea como si fuera un archivo aparte. Los datos se
+ * comparten con csv (no se copian), así que varios hilos pueden leer tramos
+ * distintos a la vez. Se libera con csv_cerrar, antes de cerrar csv.
+ */
+ArchivoCSV *csv_tramo(ArchivoCSV *csv, size_t inicio, size_t fin);
+
+// Libera el archivo; las vistas de sus campos dejan de ser válidas
+void csv_cerrar(ArchivoCSV *csv);
+
+/**
+ * Pliega un texto UTF-8 en el mismo lugar para compararlo sin distinguir
+ * mayúsculas ni acentos: las letras ASCII pasan a minúsculas, las letras
+ * latinas con tilde, diéresis, cedilla, etc. (U+00C0 a U+017F) pasan a su
+ * letra base en minúsculas ("Iñárritu" -> "inarritu", "ß" -> "ss", "Œ" ->
+ * "oe") y se eliminan las marcas diacríticas combinantes (U+0300 a U+036F).
+ * Los demás caracteres se copian sin cambios. El texto plegado nunca es más
+ * largo que el original.
+ *
+ * @param str Cadena terminada en '\0' que se reemplaza por su forma plegada.
+ */
+void plegar_texto(char *str);
+
 // Función para limpiar la pantalla
 void limpiarPantalla();
 
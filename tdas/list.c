@@ -5,12 +5,16 @@
 typedef struct Node {
   void *data;
   struct Node *next;
+  struct Node *prev; // Nodo anterior, para eliminar en O(1) en cualquier parte
 } Node;
 
 struct List {
   Node *head;
   Node *tail;
   Node *current;
+  int size;     // Número de elementos
+  Arena *arena; // NULL si los nodos se reservan con malloc
+  Node *libres; // Nodos eliminados, para reutilizarlos (solo con arena)
 };
 
 typedef List List;
@@ -23,9 +27,42 @@ List *list_create() {
   newList->head = NULL;
   newList->tail = NULL;
   newList->current = NULL;
+  newList->size = 0;
+  newList->arena = NULL;
+  newList->libres = NULL;
   return newList;
 }
 
+void list_set_arena(List *L, Arena *arena) {
+  if (L == NULL || L->head != NULL) {
+    return; // Lista no inicializada o con elementos reservados con malloc
+  }
+  L->arena = arena;
+}
+
+// Reserva un nodo, reutilizando uno eliminado si la lista usa una arena
+static Node *_new_node(List *L) {
+  if (L->arena == NULL) {
+    return (Node *)malloc(sizeof(Node));
+  }
+  if (L->libres != NULL) {
+    Node *node = L->libres;
+    L->libres = node->next;
+    return node;
+  }
+  return (Node *)arena_alloc(L->arena, sizeof(Node));
+}
+
+// Libera un nodo, o lo guarda para reutilizarlo si la lista usa una arena
+static void _free_node(List *L, Node *node) {
+  if (L->arena == NULL) {
+    free(node);
+    return;
+  }
+  node->next = L->libres;
+  L->libres = node;
+}
+
 void *list_first(List *L) {
   if (L == NULL || L->head == NULL) {
     return NULL; // Lista vacía o no inicializada
@@ -42,72 +79,108 @@ void *list_next(List *L) {
   return L->current->data;
 }
 
+void *list_iter_first(List *L, ListIter *it) {
+  it->node = L == NULL ? NULL : L->head;
+  return it->node == NULL ? NULL : it->node->data;
+}
+
+void *list_iter_next(ListIter *it) {
+  if (it->node == NULL || it->node->next == NULL) {
+    return NULL; // Recorrido terminado
+  }
+  it->node = it->node->next;
+  return it->node->data;
+}
+
+int list_size(List *L) { return L == NULL ? 0 : L->size; }
+
+// Enlaza el nodo entre prev y next (cualquiera puede ser NULL en los bordes)
+static void _link(List *L, Node *node, Node *prev, Node *next) {
+  node->prev = prev;
+  node->next = next;
+  if (prev != NULL)
+    prev->next = node;
+  else
+    L->head = node;
+  if (next != NULL)
+    next->prev = node;
+  else
+    L->tail = node;
+  L->size++;
+}
+
+// Desenlaza el nodo de la lista, libera el nodo y retorna su dato
+static void *_unlink(List *L, Node *node) {
+  if (node->prev != NULL)
+    node->prev->next = node->next;
+  else
+    L->head = node->next;
+  if (node->next != NULL)
+    node->next->prev = node->prev;
+  else
+    L->tail = node->prev;
+  if (L->current == node)
+    L->current = node->next;
+  L->size--;
+  void *data = node->data;
+  _free_node(L, node);
+  return data;
+}
+
 void list_pushFront(List *L, void *data) {
   if (L == NULL) {
     return; // Lista no inicializada
   }
-  Node *newNode = (Node *)malloc(sizeof(Node));
+  Node *newNode = _new_node(L);
   if (newNode == NULL) {
     return; // Fallo en la asignación de memoria
   }
   newNode->data = data;
-  newNode->next = L->head;
-  L->head = newNode;
-  if (L->tail == NULL) { // Si la lista estaba vacía
-    L->tail = newNode;
-  }
+  _link(L, newNode, NULL, L->head);
 }
 
 void list_pushBack(List *L, void *data) {
   if (L == NULL) {
     return; // Lista no inicializada
   }
-  Node *newNode = (Node *)malloc(sizeof(Node));
+  Node *newNode = _new_node(L);
   if (newNode == NULL) {
     return; // Fallo en la asignación de memoria
   }
   newNode->data = data;
-  newNode->next = NULL;
-  if (L->tail == NULL) { // Si la lista está vacía
-    L->head = newNode;
-    L->tail = newNode;
-  } else {
-    L->tail->next = newNode;
-    L->tail = newNode;
-  }
+  _link(L, newNode, L->tail, NULL);
 }
 
 void list_pushCurrent(List *L, void *data) {
   if (L == NULL || L->current == NULL) {
     return; // Lista no inicializada o current no está definido
   }
-  Node *newNode = (Node *)malloc(sizeof(Node));
+  Node *newNode = _new_node(L);
   if (newNode == NULL) {
     return; // Fallo en la asignación de memoria
   }
   newNode->data = data;
-  newNode->next = L->current->next;
-  L->current->next = newNode;
-  if (L->current == L->tail) {
-    L->tail = newNode; // Actualizar tail si se inserta al final
-  }
+  _link(L, newNode, L->current, L->current->next);
 }
 
-void list_sortedInsert(List *L, void *data,
-                       int (*lower_than)(void *data1, void *data2)) {
+void list_sortedInsert_ctx(List *L, void *data,
+                           int (*lower_than)(void *data1, void *data2,
+                                             void *ctx),
+                           void *ctx) {
   if (L == NULL) {
     return; // Lista no inicializada
   }
 
   // Caso especial: inserción al principio o en lista vacía
-  if (L->head == NULL || lower_than(data, L->head->data)) {
+  if (L->head == NULL || lower_than(data, L->head->data, ctx)) {
     list_pushFront(L, data);
     return;
   }
 
   // Caso general: encontrar la posición correcta para insertar
   Node *current = L->head;
-  while (current->next != NULL && !lower_than(data, current->next->data)) {
+  while (current->next != NULL &&
+         !lower_than(data, current->next->data, ctx)) {
     current = current->next;
   }
 
@@ -118,65 +191,52 @@ void list_sortedInsert(List *L, void *data,
   list_pushCurrent(L, data);
 }
 
+// Comparador sin contexto, que list_sortedInsert pasa como contexto
+typedef struct {
+  int (*lower_than)(void *data1, void *data2);
+} ComparadorSimple;
+
+static int _lower_than_simple(void *data1, void *data2, void *ctx) {
+  return ((ComparadorSimple *)ctx)->lower_than(data1, data2);
+}
+
+void list_sortedInsert(List *L, void *data,
+                       int (*lower_than)(void *data1, void *data2)) {
+  ComparadorSimple comparador = {lower_than};
+  list_sortedInsert_ctx(L, data, _lower_than_simple, &comparador);
+}
+
 void *list_popFront(List *L) {
   if (L == NULL || L->head == NULL) {
     return NULL; // Lista vacía o no inicializada
   }
-  Node *temp = L->head;
-  L->head = L->head->next;
-  if (L->head == NULL) {
-    L->tail = NULL; // La lista ahora está vacía
-  }
-  void *data = temp->data;
-  free(temp);
-  return data;
+  return _unlink(L, L->head);
 }
 
 void *list_popBack(List *L) {
-  if (L == NULL || L->head == NULL) {
+  if (L == NULL || L->tail == NULL) {
     return NULL; // Lista vacía o no inicializada
   }
-  if (L->head == L->tail) { // Solo un elemento en la lista
-    return list_popFront(L);
-  }
-  Node *current = L->head;
-  while (current->next != L->tail) {
-    current = current->next;
-  }
-  void *data = L->tail->data;
-  free(L->tail);
-  current->next = NULL;
-  L->tail = current;
-  return data;
+  return _unlink(L, L->tail);
 }
 
 void *list_popCurrent(List *L) {
   if (L == NULL || L->current == NULL) {
     return NULL; // Lista no inicializada o current no definido
   }
-  if (L->current == L->head) {
-    return list_popFront(L);
-  }
-  Node *temp = L->head;
-  while (temp != NULL && temp->next != L->current) {
-    temp = temp->next;
-  }
-
-  temp->next = L->current->next;
-  if (L->current == L->tail) {
-    L->tail = temp; // Actualizar tail si se elimina el último elemento
-  }
-  void *data = L->current->data;
-  free(L->current);
-  L->current = temp->next;
-  return data;
+  return _unlink(L, L->current); // current pasa al siguiente
 }
 
 void list_clean(List *L) {
   if (L == NULL) {
     return; // Lista no inicializada
   }
-  Node *current = L->head;
+  if (L->arena != NULL && L->head != NULL) {
+    // Con arena todos los nodos pasan de una vez a la lista de libres
+    L->tail->next = L->libres;
+    L->libres = L->head;
+  }
+  Node *current = L->arena == NULL ? L->head : NULL;
   Node *next;
   while (current != NULL) {
     next = current->next;
@@ -186,4 +246,5 @@ void list_clean(List *L) {
   L->head = NULL;
   L->tail = NULL;
   L->current = NULL;
+  L->size = 0;
 }
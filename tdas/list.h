@@ -1,11 +1,25 @@
 #ifndef LIST_H
 #define LIST_H
+#include "arena.h"
 
 typedef struct List List;
 
+// Iterador externo de una lista: se declara en la pila del que recorre y no
+// modifica la lista, por lo que varios recorridos (anidados o en distintos
+// hilos) pueden avanzar a la vez sin mover el elemento actual. Deja de ser
+// válido si se elimina el elemento en que está.
+typedef struct {
+  struct Node *node;
+} ListIter;
+
 // Esta función crea una lista vacía y devuelve un puntero a la lista.
 List *list_create();
 
+// Esta función hace que los nodos de la lista (vacía) se reserven en la arena.
+// Los nodos eliminados se reutilizan en inserciones posteriores y su memoria
+// se libera con arena_clean, no con list_clean.
+void list_set_arena(List *L, Arena *arena);
+
 // Esta función devuelve un puntero al primer elemento de la lista.
 void *list_first(List *L);
 
@@ -13,6 +27,17 @@ void *list_first(List *L);
 // puntero a dicho elemento.
 void *list_next(List *L);
 
+// Esta función deja el iterador en el primer elemento de la lista y lo
+// devuelve, o NULL si la lista está vacía.
+void *list_iter_first(List *L, ListIter *it);
+
+// Esta función mueve el iterador al siguiente elemento y lo devuelve, o NULL
+// si no hay más elementos.
+void *list_iter_next(ListIter *it);
+
+// Esta función retorna el número de elementos de la lista, en O(1).
+int list_size(List *L);
+
 // Esta función inserta un nuevo elemento al inicio de la lista.
 void list_pushFront(List *L, void *dato);
 
@@ -25,10 +50,11 @@ void list_pushCurrent(List *L, void *dato);
 // Esta función elimina el primer elemento de la lista.
 void *list_popFront(List *L);
 
-// Esta función elimina el último elemento de la lista.
+// Esta función elimina el último elemento de la lista, en O(1).
 void *list_popBack(List *L);
 
-// Esta función elimina el elemento actual de la lista.
+// Esta función elimina el elemento actual de la lista en O(1); el siguiente
+// pasa a ser el actual.
 void *list_popCurrent(List *L);
 
 // Esta función elimina todos los elementos de la lista.
@@ -38,4 +64,11 @@ void list_clean(List *L);
 void list_sortedInsert(List *L, void *data,
                        int (*lower_than)(void *data1, void *data2));
 
+// Esta función inserta ordenado como list_sortedInsert, con un comparador que
+// recibe además el puntero `ctx`.
+void list_sortedInsert_ctx(List *L, void *data,
+                           int (*lower_than)(void *data1, void *data2,
+                                             void *ctx),
+                           void *ctx);
+
 #endif
\ No newline at end of file
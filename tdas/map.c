@@ -1,82 +1,579 @@
 #include "map.h"
-#include "list.h"
+#include "vector.h"
 #include <stdio.h>
 #include <stdlib.h>
 
+#define SLOT_VACIO -1
+#define SLOT_BORRADO -2
+#define MIN_SLOTS 16
+
+// Nodo del árbol AVL usado por los mapas ordenados. El par va al inicio del
+// nodo, de modo que el MapPair* que retorna map_remove puede liberarse con free.
+typedef struct TreeNode {
+  MapPair pair;
+  struct TreeNode *left;
+  struct TreeNode *right;
+  struct TreeNode *parent;
+  int height;
+} TreeNode;
+
 struct Map {
-  int (*lower_than)(void *key1, void *key2);
+  // Comparador de los mapas ordenados, que recibe el contexto `ctx` del mapa.
+  // Los mapas de sorted_map_create guardan su comparador en `lower_than_simple`
+  // y usan como contexto el propio mapa.
+  int (*lower_than)(void *key1, void *key2, void *ctx);
+  void *ctx;
+  int (*lower_than_simple)(void *key1, void *key2);
   int (*is_equal)(void *key1, void *key2);
-  List *ls;
+  unsigned long (*hash)(void *key);
+  Vector *lineal; // Solo para mapas creados con map_create
+  Arena *arena; // NULL si los pares se reservan con malloc
+
+  // Árbol AVL (solo si lower_than != NULL)
+  TreeNode *root;
+  TreeNode *tcurrent; // cursor de iteración del árbol
+
+  // Tabla hash (solo si hash != NULL). Los pares se guardan en `pairs` en
+  // orden de inserción; `slots` es la tabla de direccionamiento abierto con
+  // sondeo lineal que guarda índices dentro de `pairs`.
+  MapPair **pairs;       // NULL en las posiciones eliminadas
+  unsigned long *hashes; // hash de cada par, para no recalcularlo
+  long size;             // posiciones ocupadas en `pairs` (incluye eliminadas)
+  long capacity;         // capacidad de `pairs` y `hashes`
+  long count;            // pares vivos
+  long *slots;
+  long nslots;           // siempre potencia de 2
+  long nborrados;        // slots marcados como SLOT_BORRADO
+  long current;          // cursor de iteración dentro de `pairs`
 };
 
 typedef Map Map;
 
-// Variable global para almacenar la función de comparación actual
-int (*current_lt)(void *, void *) = NULL;
+Map *sorted_map_create_ctx(int (*lower_than)(void *key1, void *key2,
+                                             void *ctx),
+                           void *ctx) {
+  Map *newMap = (Map *)calloc(1, sizeof(Map));
+  if (newMap == NULL)
+    return NULL; // Fallo en la asignación de memoria
+  newMap->lower_than = lower_than;
+  newMap->ctx = ctx;
+  newMap->is_equal = NULL;
+
+  return newMap;
+}
 
-int pair_lt(void *pair1, void *pair2) {
-  return (current_lt(((MapPair *)pair1)->key, ((MapPair *)pair2)->key));
+// Comparador de los mapas de sorted_map_create: el contexto es el mapa
+static int _lower_than_simple(void *key1, void *key2, void *ctx) {
+  return ((Map *)ctx)->lower_than_simple(key1, key2);
 }
 
 Map *sorted_map_create(int (*lower_than)(void *key1, void *key2)) {
-  Map *newMap = (Map *)malloc(sizeof(Map));
-  newMap->lower_than = lower_than;
-  newMap->is_equal = NULL;
-  newMap->ls = list_create();
+  Map *newMap = sorted_map_create_ctx(_lower_than_simple, NULL);
+  if (newMap == NULL)
+    return NULL; // Fallo en la asignación de memoria
+  newMap->ctx = newMap;
+  newMap->lower_than_simple = lower_than;
 
   return newMap;
 }
 
 Map *map_create(int (*is_equal)(void *key1, void *key2)) {
-  Map *newMap = (Map *)malloc(sizeof(Map));
+  Map *newMap = (Map *)calloc(1, sizeof(Map));
   newMap->lower_than = NULL;
   newMap->is_equal = is_equal;
-  newMap->ls = list_create();
+  newMap->lineal = vector_create();
 
   return newMap;
 }
 
-void map_insert(Map *map, void *key, void *value) {
-  if (map_search(map, key) != NULL) return;
+Map *hash_map_create(unsigned long (*hash)(void *key),
+                     int (*is_equal)(void *key1, void *key2)) {
+  Map *newMap = (Map *)calloc(1, sizeof(Map));
+  if (newMap == NULL)
+    return NULL; // Fallo en la asignación de memoria
+  newMap->is_equal = is_equal;
+  newMap->hash = hash;
+  return newMap;
+}
+
+void map_set_arena(Map *map, Arena *arena) {
+  map->arena = arena;
+}
+
+// Reserva memoria para un par o nodo del mapa
+static void *_alloc(Map *map, size_t size) {
+  return map->arena ? arena_alloc(map->arena, size) : malloc(size);
+}
+
+/* ---------- Tabla hash ---------- */
+
+// Busca el slot que contiene la clave. Retorna el índice del slot o -1.
+static long _hash_find_slot(Map *map, void *key, unsigned long h) {
+  if (map->nslots == 0)
+    return -1;
+  long mask = map->nslots - 1;
+  for (long i = (long)(h & mask);; i = (i + 1) & mask) {
+    long idx = map->slots[i];
+    if (idx == SLOT_VACIO)
+      return -1;
+    if (idx != SLOT_BORRADO && map->hashes[idx] == h &&
+        map->is_equal(map->pairs[idx]->key, key))
+      return i;
+  }
+}
+
+// Reconstruye la tabla con el tamaño adecuado para `count` pares, compactando
+// las posiciones eliminadas de `pairs`.
+static int _hash_rehash(Map *map) {
+  long nslots = MIN_SLOTS;
+  while (nslots < (map->count + 1) * 2) // factor de carga <= 0.5 tras rehash
+    nslots *= 2;
+
+  long *slots = (long *)malloc(nslots * sizeof(long));
+  if (slots == NULL)
+    return 0; // Fallo en la asignación de memoria
+  for (long i = 0; i < nslots; i++)
+    slots[i] = SLOT_VACIO;
+
+  long mask = nslots - 1;
+  long j = 0, current = map->current;
+  for (long i = 0; i < map->size; i++) {
+    if (map->pairs[i] == NULL) {
+      if (i < map->current)
+        current--;
+      continue;
+    }
+    map->pairs[j] = map->pairs[i];
+    map->hashes[j] = map->hashes[i];
+    long s = (long)(map->hashes[j] & mask);
+    while (slots[s] != SLOT_VACIO)
+      s = (s + 1) & mask;
+    slots[s] = j++;
+  }
+
+  free(map->slots);
+  map->slots = slots;
+  map->nslots = nslots;
+  map->nborrados = 0;
+  map->size = j;
+  map->current = current;
+  return 1;
+}
+
+static void _hash_insert(Map *map, void *key, void *value) {
+  unsigned long h = map->hash(key);
+  if (_hash_find_slot(map, key, h) != -1)
+    return;
 
-  MapPair *pair = (MapPair *)malloc(sizeof(MapPair));
+  // Si `pairs` está lleno se compacta (cuando la mitad son eliminados) o se
+  // duplica su capacidad
+  if (map->size == map->capacity) {
+    if (map->count * 2 <= map->size && map->size > 0) {
+      if (!_hash_rehash(map))
+        return;
+    } else {
+      long capacity = map->capacity ? map->capacity * 2 : MIN_SLOTS;
+      MapPair **pairs =
+          (MapPair **)realloc(map->pairs, capacity * sizeof(MapPair *));
+      if (pairs == NULL)
+        return; // Fallo en la asignación de memoria
+      map->pairs = pairs;
+      unsigned long *hashes = (unsigned long *)realloc(
+          map->hashes, capacity * sizeof(unsigned long));
+      if (hashes == NULL)
+        return; // Fallo en la asignación de memoria
+      map->hashes = hashes;
+      map->capacity = capacity;
+    }
+  }
+
+  // Mantiene el factor de carga (incluyendo borrados) por debajo de 0.75
+  if ((map->count + map->nborrados + 1) * 4 > map->nslots * 3 &&
+      !_hash_rehash(map))
+    return;
+
+  MapPair *pair = (MapPair *)_alloc(map, sizeof(MapPair));
+  if (pair == NULL)
+    return;
   pair->key = key;
   pair->value = value;
 
-  if (map->lower_than) {
-    current_lt = map->lower_than;
-    list_sortedInsert(map->ls, pair, pair_lt);
-  } else
-    list_pushBack(map->ls, pair);
+  long mask = map->nslots - 1;
+  long s = (long)(h & mask);
+  while (map->slots[s] >= 0)
+    s = (s + 1) & mask;
+  if (map->slots[s] == SLOT_BORRADO)
+    map->nborrados--;
+
+  map->pairs[map->size] = pair;
+  map->hashes[map->size] = h;
+  map->slots[s] = map->size++;
+  map->count++;
+}
+
+static MapPair *_hash_remove(Map *map, void *key) {
+  long s = _hash_find_slot(map, key, map->hash(key));
+  if (s == -1)
+    return NULL;
+  long idx = map->slots[s];
+  MapPair *pair = map->pairs[idx];
+  map->pairs[idx] = NULL;
+  map->slots[s] = SLOT_BORRADO;
+  map->nborrados++;
+  map->count--;
+  return pair;
+}
+
+// Primera posición de `pairs` desde i que no está eliminada (size si no hay)
+static long _hash_skip(Map *map, long i) {
+  while (i < map->size && map->pairs[i] == NULL)
+    i++;
+  return i;
+}
+
+static MapPair *_hash_next_from(Map *map, long i) {
+  map->current = _hash_skip(map, i);
+  return map->current < map->size ? map->pairs[map->current] : NULL;
+}
+
+/* ---------- Árbol AVL ---------- */
+
+static int _height(TreeNode *n) { return n ? n->height : 0; }
+
+static void _update_height(TreeNode *n) {
+  int hl = _height(n->left), hr = _height(n->right);
+  n->height = (hl > hr ? hl : hr) + 1;
+}
+
+// Reemplaza el subárbol con raíz u por el subárbol con raíz v
+static void _transplant(Map *map, TreeNode *u, TreeNode *v) {
+  if (u->parent == NULL)
+    map->root = v;
+  else if (u == u->parent->left)
+    u->parent->left = v;
+  else
+    u->parent->right = v;
+  if (v != NULL)
+    v->parent = u->parent;
+}
+
+static TreeNode *_rotate_left(Map *map, TreeNode *x) {
+  TreeNode *y = x->right;
+  x->right = y->left;
+  if (y->left != NULL)
+    y->left->parent = x;
+  _transplant(map, x, y);
+  y->left = x;
+  x->parent = y;
+  _update_height(x);
+  _update_height(y);
+  return y;
+}
+
+static TreeNode *_rotate_right(Map *map, TreeNode *x) {
+  TreeNode *y = x->left;
+  x->left = y->right;
+  if (y->right != NULL)
+    y->right->parent = x;
+  _transplant(map, x, y);
+  y->right = x;
+  x->parent = y;
+  _update_height(x);
+  _update_height(y);
+  return y;
+}
+
+// Recorre desde n hasta la raíz actualizando alturas y rotando donde el
+// factor de balance quede fuera de [-1, 1]
+static void _rebalance(Map *map, TreeNode *n) {
+  while (n != NULL) {
+    _update_height(n);
+    int balance = _height(n->left) - _height(n->right);
+    if (balance > 1) {
+      if (_height(n->left->left) < _height(n->left->right))
+        _rotate_left(map, n->left);
+      n = _rotate_right(map, n);
+    } else if (balance < -1) {
+      if (_height(n->right->right) < _height(n->right->left))
+        _rotate_right(map, n->right);
+      n = _rotate_left(map, n);
+    }
+    n = n->parent;
+  }
+}
+
+static TreeNode *_minimum(TreeNode *n) {
+  while (n != NULL && n->left != NULL)
+    n = n->left;
+  return n;
+}
+
+static TreeNode *_successor(TreeNode *n) {
+  if (n->right != NULL)
+    return _minimum(n->right);
+  while (n->parent != NULL && n == n->parent->right)
+    n = n->parent;
+  return n->parent;
+}
+
+static TreeNode *_tree_find(Map *map, void *key) {
+  TreeNode *n = map->root;
+  while (n != NULL) {
+    if (map->lower_than(key, n->pair.key, map->ctx))
+      n = n->left;
+    else if (map->lower_than(n->pair.key, key, map->ctx))
+      n = n->right;
+    else
+      return n;
+  }
+  return NULL;
+}
+
+static void _tree_insert(Map *map, void *key, void *value) {
+  TreeNode *parent = NULL;
+  TreeNode **link = &map->root;
+  while (*link != NULL) {
+    parent = *link;
+    if (map->lower_than(key, parent->pair.key, map->ctx))
+      link = &parent->left;
+    else if (map->lower_than(parent->pair.key, key, map->ctx))
+      link = &parent->right;
+    else
+      return; // La clave ya existe
+  }
+
+  TreeNode *node = (TreeNode *)_alloc(map, sizeof(TreeNode));
+  if (node == NULL)
+    return; // Fallo en la asignación de memoria
+  node->pair.key = key;
+  node->pair.value = value;
+  node->left = node->right = NULL;
+  node->parent = parent;
+  node->height = 1;
+  *link = node;
+  _rebalance(map, parent);
+}
+
+static MapPair *_tree_remove(Map *map, void *key) {
+  TreeNode *z = _tree_find(map, key);
+  if (z == NULL)
+    return NULL;
+  if (map->tcurrent == z)
+    map->tcurrent = _successor(z);
+
+  TreeNode *start; // Nodo más bajo cuya altura puede haber cambiado
+  if (z->left == NULL) {
+    start = z->parent;
+    _transplant(map, z, z->right);
+  } else if (z->right == NULL) {
+    start = z->parent;
+    _transplant(map, z, z->left);
+  } else {
+    TreeNode *y = _minimum(z->right);
+    if (y->parent != z) {
+      start = y->parent;
+      _transplant(map, y, y->right);
+      y->right = z->right;
+      y->right->parent = y;
+    } else {
+      start = y;
+    }
+    _transplant(map, z, y);
+    y->left = z->left;
+    y->left->parent = y;
+    y->height = z->height;
+  }
+  _rebalance(map, start);
+  return &z->pair;
+}
+
+// Primer nodo cuya clave no es menor que key (strict = 0) o que es mayor que
+// key (strict = 1)
+static TreeNode *_tree_bound(Map *map, void *key, int strict) {
+  TreeNode *n = map->root, *res = NULL;
+  while (n != NULL) {
+    int goes_left = strict ? map->lower_than(key, n->pair.key, map->ctx)
+                           : !map->lower_than(n->pair.key, key, map->ctx);
+    if (goes_left) {
+      res = n;
+      n = n->left;
+    } else {
+      n = n->right;
+    }
+  }
+  return res;
 }
 
-int _is_equal(Map *map, MapPair *pair, void *key) {
-  return ((map->is_equal && map->is_equal(pair->key, key)) ||
-          (map->lower_than && !map->lower_than(pair->key, key) &&
-           !map->lower_than(key, pair->key)));
+static void _tree_free(TreeNode *n) {
+  if (n == NULL)
+    return;
+  _tree_free(n->left);
+  _tree_free(n->right);
+  free(n);
+}
+
+static MapPair *_node_pair(TreeNode *n) { return n ? &n->pair : NULL; }
+
+static MapPair *_tree_set_current(Map *map, TreeNode *n) {
+  map->tcurrent = n;
+  return _node_pair(n);
+}
+
+/* ---------- API ---------- */
+
+void map_insert(Map *map, void *key, void *value) {
+  if (map->hash) {
+    _hash_insert(map, key, value);
+    return;
+  }
+
+  if (map->lower_than) {
+    _tree_insert(map, key, value);
+    return;
+  }
+
+  if (map_search(map, key) != NULL) return;
+
+  MapPair *pair = (MapPair *)_alloc(map, sizeof(MapPair));
+  if (pair == NULL)
+    return; // Fallo en la asignación de memoria
+  pair->key = key;
+  pair->value = value;
+  vector_pushBack(map->lineal, pair);
 }
 
 MapPair *map_remove(Map *map, void *key) {
-  for (MapPair *pair = list_first(map->ls); pair != NULL;
-       pair = list_next(map->ls))
-    if (_is_equal(map, pair, key)) {
-      list_popCurrent(map->ls);
+  if (map->hash)
+    return _hash_remove(map, key);
+  if (map->lower_than)
+    return _tree_remove(map, key);
+
+  for (MapPair *pair = vector_first(map->lineal); pair != NULL;
+       pair = vector_next(map->lineal))
+    if (map->is_equal(pair->key, key)) {
+      vector_popCurrent(map->lineal);
       return pair;
     }
   return NULL;
 }
 
 MapPair *map_search(Map *map, void *key) {
-  for (MapPair *pair = list_first(map->ls); pair != NULL;
-       pair = list_next(map->ls)) {
-    if (_is_equal(map, pair, key))
+  if (map->hash) {
+    long s = _hash_find_slot(map, key, map->hash(key));
+    return s == -1 ? NULL : map->pairs[map->slots[s]];
+  }
+  if (map->lower_than) {
+    TreeNode *n = _tree_find(map, key);
+    return n ? &n->pair : NULL;
+  }
+
+  MapPair **pairs = (MapPair **)vector_data(map->lineal);
+  for (int i = 0, n = vector_size(map->lineal); i < n; i++) {
+    MapPair *pair = pairs[i];
+    if (map->is_equal(pair->key, key))
       return pair;
   }
   return NULL;
 }
 
-MapPair *map_first(Map *map) { return list_first(map->ls); }
+MapPair *map_first(Map *map) {
+  if (map->hash)
+    return _hash_next_from(map, 0);
+  if (map->lower_than)
+    return _tree_set_current(map, _minimum(map->root));
+  return vector_first(map->lineal);
+}
+
+MapPair *map_next(Map *map) {
+  if (map->hash)
+    return _hash_next_from(map, map->current + 1);
+  if (map->lower_than)
+    return map->tcurrent ? _tree_set_current(map, _successor(map->tcurrent))
+                         : NULL;
+  return vector_next(map->lineal);
+}
+
+MapPair *map_lower_bound(Map *map, void *key) {
+  if (map->lower_than == NULL)
+    return NULL; // Solo definido para mapas ordenados
+  return _tree_set_current(map, _tree_bound(map, key, 0));
+}
+
+MapPair *map_upper_bound(Map *map, void *key) {
+  if (map->lower_than == NULL)
+    return NULL; // Solo definido para mapas ordenados
+  return _tree_set_current(map, _tree_bound(map, key, 1));
+}
 
-MapPair *map_next(Map *map) { return list_next(map->ls); }
+MapPair *map_iter_first(Map *map, MapIter *it) {
+  it->map = map;
+  it->pos = -1;
+  if (map->lower_than) {
+    it->node = _minimum(map->root);
+    return _node_pair(it->node);
+  }
+  it->node = NULL;
+  return map_iter_next(it);
+}
 
-void map_clean(Map *map) { list_clean(map->ls); }
+MapPair *map_iter_next(MapIter *it) {
+  Map *map = it->map;
+  if (map->hash) {
+    it->pos = _hash_skip(map, it->pos + 1);
+    return it->pos < map->size ? map->pairs[it->pos] : NULL;
+  }
+  if (map->lower_than) {
+    if (it->node != NULL)
+      it->node = _successor(it->node);
+    return _node_pair(it->node);
+  }
+  if (it->pos + 1 >= vector_size(map->lineal))
+    return NULL;
+  return vector_data(map->lineal)[++it->pos];
+}
+
+// Deja el iterador en el primer par cuya clave no es menor que key (strict =
+// 0) o que es mayor que key (strict = 1). En un mapa no ordenado lo deja al
+// final, de modo que map_iter_next tampoco retorna pares.
+static MapPair *_iter_bound(Map *map, void *key, MapIter *it, int strict) {
+  it->map = map;
+  it->node = map->lower_than ? _tree_bound(map, key, strict) : NULL;
+  it->pos = map->hash ? map->size : vector_size(map->lineal);
+  return _node_pair(it->node);
+}
+
+MapPair *map_iter_lower_bound(Map *map, void *key, MapIter *it) {
+  return _iter_bound(map, key, it, 0);
+}
+
+MapPair *map_iter_upper_bound(Map *map, void *key, MapIter *it) {
+  return _iter_bound(map, key, it, 1);
+}
+
+void map_clean(Map *map) {
+  if (map->hash) {
+    for (long i = 0; map->arena == NULL && i < map->size; i++)
+      free(map->pairs[i]);
+    free(map->pairs);
+    free(map->hashes);
+    free(map->slots);
+    map->pairs = NULL;
+    map->hashes = NULL;
+    map->slots = NULL;
+    map->size = map->capacity = map->count = 0;
+    map->nslots = map->nborrados = map->current = 0;
+    return;
+  }
+  if (map->lower_than) {
+    if (map->arena == NULL)
+      _tree_free(map->root);
+    map->root = NULL;
+    map->tcurrent = NULL;
+    return;
+  }
+
+  if (map->arena == NULL)
+    for (int i = 0; i < vector_size(map->lineal); i++)
+      free(vector_data(map->lineal)[i]);
+  vector_clean(map->lineal);
+}
@@ -1,5 +1,6 @@
 #ifndef MAP_H
 #define MAP_H
+#include "arena.h"
 #include "list.h"
 #include <stdio.h>
 #include <stdlib.h>
@@ -11,10 +12,44 @@ typedef struct {
 
 typedef struct Map Map;
 
+// Iterador externo de un mapa: se declara en la pila del que recorre y no
+// modifica el mapa (a diferencia de map_first/map_next, que guardan el par
+// actual en el mapa), por lo que varios recorridos y búsquedas pueden hacerse
+// a la vez, también desde distintos hilos mientras nadie modifique el mapa.
+typedef struct {
+  Map *map;
+  struct TreeNode *node; // Mapas ordenados
+  long pos;              // Mapas con hash y mapas de map_create
+} MapIter;
+
 Map *map_create(int (*is_equal)(void *key1, void *key2)); // unsorted map
 
+// Mapa no ordenado respaldado por una tabla hash de direccionamiento abierto.
+// La función hash debe ser consistente con is_equal (claves iguales => mismo
+// hash). Inserción, búsqueda y eliminación toman O(1) esperado y la iteración
+// con map_first/map_next recorre los pares en orden de inserción.
+Map *hash_map_create(unsigned long (*hash)(void *key),
+                     int (*is_equal)(void *key1, void *key2));
+
+// Mapa ordenado respaldado por un árbol AVL. Inserción, búsqueda y
+// eliminación toman O(log n) y map_first/map_next recorren los pares en orden
+// creciente de clave.
 Map *sorted_map_create(int (*lower_than)(void *key1, void *key2));
 
+// Mapa ordenado cuyo comparador recibe además el puntero `ctx` (por ejemplo
+// la tabla con los datos de las claves), en vez de leerlo de una variable
+// global. Cada mapa guarda su propio comparador y contexto, por lo que
+// distintos hilos pueden construir mapas distintos a la vez.
+Map *sorted_map_create_ctx(int (*lower_than)(void *key1, void *key2,
+                                             void *ctx),
+                           void *ctx);
+
+// Hace que los pares (y nodos) del mapa, que debe estar vacío, se reserven en
+// la arena. Así la carga de muchos pares no hace un malloc por par y todos se
+// liberan juntos con arena_clean. Los pares que retorna map_remove no deben
+// liberarse con free y map_clean no libera los pares.
+void map_set_arena(Map *map, Arena *arena);
+
 void map_insert(Map *map, void *key, void *value);
 
 MapPair *map_remove(Map *map, void *key);
@@ -25,6 +60,25 @@ MapPair *map_first(Map *map);
 
 MapPair *map_next(Map *map);
 
+// Solo para mapas ordenados: retorna el primer par cuya clave no es menor que
+// key (lower bound) o que es mayor que key (upper bound), o NULL si no existe.
+// El par queda como actual, por lo que map_next continúa el recorrido en orden
+// y un rango [a, b] se recorre en O(log n + k).
+MapPair *map_lower_bound(Map *map, void *key);
+
+MapPair *map_upper_bound(Map *map, void *key);
+
+// Recorren el mapa con un iterador externo, en el mismo orden que
+// map_first/map_next y sin cambiar el par actual del mapa.
+MapPair *map_iter_first(Map *map, MapIter *it);
+
+MapPair *map_iter_next(MapIter *it);
+
+// Como map_lower_bound y map_upper_bound, pero dejan el par en el iterador.
+MapPair *map_iter_lower_bound(Map *map, void *key, MapIter *it);
+
+MapPair *map_iter_upper_bound(Map *map, void *key, MapIter *it);
+
 void map_clean(Map *map);
 
-#endif /* MAP_H */
\ No newline at end of file
+#endif /* MAP_H */
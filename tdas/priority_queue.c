@@ -1,32 +1,186 @@
 #include "priority_queue.h"
-#include "list.h"
-#include "map.h"
-#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
-int _int_lower_than(void *key1, void *key2) {
-  return *((int *)key1) < *((int *)key2);
-}
+// Hijos por nodo del montículo: con 4 el montículo es la mitad de alto que
+// uno binario y los hijos de un nodo quedan seguidos en memoria
+#define ARIDAD 4
+#define MIN_CAPACIDAD 16
+
+typedef struct {
+  int priority;
+  int handle;          // posición en posiciones, o -1 si no tiene
+  unsigned long orden; // orden de inserción, para desempatar
+  void *data;
+} Entrada;
+
+struct PQueue {
+  Entrada *heap; // heap[0] es el elemento de mayor prioridad
+  int size;
+  int capacity;
+
+  // posiciones[h] es el índice en heap del elemento con handle h, o -1 si
+  // está libre; los handles libres se apilan en libres
+  int *posiciones;
+  int *libres;
+  int n_handles;
+  int n_libres;
+  int cap_handles;
+
+  unsigned long siguiente_orden;
+};
 
 PQueue *pqueue_create(PQueue *queue) {
-  return sorted_map_create(_int_lower_than);
+  return (PQueue *)calloc(1, sizeof(PQueue)); // NULL si falla la asignación
+}
+
+// Retorna 1 si a debe salir antes que b
+static int _before(const Entrada *a, const Entrada *b) {
+  return a->priority > b->priority ||
+         (a->priority == b->priority && a->orden < b->orden);
+}
+
+// Deja la entrada e en la posición i del montículo
+static void _place(PQueue *queue, int i, Entrada e) {
+  queue->heap[i] = e;
+  if (e.handle != -1)
+    queue->posiciones[e.handle] = i;
+}
+
+static void _sift_up(PQueue *queue, int i) {
+  Entrada e = queue->heap[i];
+  while (i > 0) {
+    int padre = (i - 1) / ARIDAD;
+    if (!_before(&e, &queue->heap[padre]))
+      break;
+    _place(queue, i, queue->heap[padre]);
+    i = padre;
+  }
+  _place(queue, i, e);
+}
+
+static void _sift_down(PQueue *queue, int i) {
+  Entrada e = queue->heap[i];
+  while (1) {
+    int primero = i * ARIDAD + 1;
+    if (primero >= queue->size)
+      break;
+    int ultimo = primero + ARIDAD < queue->size ? primero + ARIDAD
+                                                : queue->size;
+    int mejor = primero;
+    for (int h = primero + 1; h < ultimo; h++)
+      if (_before(&queue->heap[h], &queue->heap[mejor]))
+        mejor = h;
+    if (!_before(&queue->heap[mejor], &e))
+      break;
+    _place(queue, i, queue->heap[mejor]);
+    i = mejor;
+  }
+  _place(queue, i, e);
+}
+
+// Asegura espacio para n elementos más. Retorna 0 si falla la asignación.
+static int _reserve(PQueue *queue, int n) {
+  if (queue->size + n <= queue->capacity)
+    return 1;
+  int capacity = queue->capacity ? queue->capacity : MIN_CAPACIDAD;
+  while (capacity < queue->size + n)
+    capacity *= 2;
+  Entrada *heap = (Entrada *)realloc(queue->heap, capacity * sizeof(Entrada));
+  if (heap == NULL)
+    return 0;
+  queue->heap = heap;
+  queue->capacity = capacity;
+  return 1;
+}
+
+// Retorna un handle libre, o -1 si falla la asignación de memoria
+static int _new_handle(PQueue *queue) {
+  if (queue->n_libres > 0)
+    return queue->libres[--queue->n_libres];
+  if (queue->n_handles == queue->cap_handles) {
+    int cap = queue->cap_handles ? queue->cap_handles * 2 : MIN_CAPACIDAD;
+    int *posiciones = (int *)realloc(queue->posiciones, cap * sizeof(int));
+    if (posiciones == NULL)
+      return -1;
+    queue->posiciones = posiciones;
+    int *libres = (int *)realloc(queue->libres, cap * sizeof(int));
+    if (libres == NULL)
+      return -1;
+    queue->libres = libres;
+    queue->cap_handles = cap;
+  }
+  return queue->n_handles++;
+}
+
+static int _insert(PQueue *queue, int priority, void *data, int con_handle) {
+  if (!_reserve(queue, 1))
+    return -1;
+  int handle = con_handle ? _new_handle(queue) : -1;
+  if (con_handle && handle == -1)
+    return -1;
+  int i = queue->size++;
+  _place(queue, i,
+         (Entrada){priority, handle, queue->siguiente_orden++, data});
+  _sift_up(queue, i);
+  return handle;
 }
 
 void pqueue_insert(PQueue *queue, int priority, void *data) {
-  int *priority_ptr = (int *)malloc(sizeof(int));
-  *priority_ptr = -priority;
-  map_insert(queue, priority_ptr, data);
+  _insert(queue, priority, data, 0);
+}
+
+int pqueue_insert_handle(PQueue *queue, int priority, void *data) {
+  return _insert(queue, priority, data, 1);
+}
+
+void pqueue_update(PQueue *queue, int handle, int priority) {
+  int i = queue->posiciones[handle];
+  int anterior = queue->heap[i].priority;
+  queue->heap[i].priority = priority;
+  if (priority > anterior)
+    _sift_up(queue, i);
+  else
+    _sift_down(queue, i);
+}
+
+void pqueue_heapify(PQueue *queue, const int *priorities, void **datos,
+                    int n) {
+  if (n <= 0 || !_reserve(queue, n))
+    return;
+  for (int k = 0; k < n; k++)
+    queue->heap[queue->size++] =
+        (Entrada){priorities[k], -1, queue->siguiente_orden++, datos[k]};
+  // Construcción de Floyd: se hunden los nodos internos desde el último
+  for (int i = (queue->size - 2) / ARIDAD; i >= 0; i--)
+    _sift_down(queue, i);
 }
 
 void *pqueue_remove(PQueue *queue) {
-  MapPair *pair = list_popFront((List *)queue);
-  free(pair->key);
-  return pair->value;
+  if (queue->size == 0)
+    return NULL;
+  Entrada primero = queue->heap[0];
+  if (primero.handle != -1) {
+    queue->posiciones[primero.handle] = -1;
+    queue->libres[queue->n_libres++] = primero.handle;
+  }
+  queue->size--;
+  if (queue->size > 0) {
+    _place(queue, 0, queue->heap[queue->size]);
+    _sift_down(queue, 0);
+  }
+  return primero.data;
 }
 
 void *pqueue_front(PQueue *queue) {
-  MapPair *pair = list_first((List *)queue);
-  return pair->value;
+  return queue->size > 0 ? queue->heap[0].data : NULL;
 }
 
-void pqueue_clean(PQueue *queue) { list_clean((List *)queue); }
\ No newline at end of file
+int pqueue_size(PQueue *queue) { return queue->size; }
+
+void pqueue_clean(PQueue *queue) {
+  free(queue->heap);
+  free(queue->posiciones);
+  free(queue->libres);
+  memset(queue, 0, sizeof(PQueue));
+}
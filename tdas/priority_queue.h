@@ -1,18 +1,48 @@
 #ifndef PQUEUE_H
 #define PQUEUE_H
-#include "list.h"
-#include "map.h"
 
-typedef struct Map PQueue;
+// Cola de prioridad respaldada por un montículo 4-ario en un arreglo: cada
+// elemento guarda su prioridad en el mismo arreglo (sin un malloc por
+// elemento) y los de mayor prioridad salen primero. Los elementos de igual
+// prioridad salen en el orden en que se insertaron.
+typedef struct PQueue PQueue;
 
+// Esta función crea una cola de prioridad vacía. Retorna NULL si falla la
+// asignación de memoria.
 PQueue *pqueue_create(PQueue *queue);
 
+// Esta función inserta un elemento en O(log n).
 void pqueue_insert(PQueue *queue, int priority, void *data);
 
+// Esta función inserta un elemento y retorna un identificador (handle) para
+// cambiar su prioridad con pqueue_update mientras siga en la cola, o -1 si
+// falla la asignación de memoria. Un handle puede reutilizarse para otro
+// elemento después de que el suyo sale de la cola.
+int pqueue_insert_handle(PQueue *queue, int priority, void *data);
+
+// Esta función cambia la prioridad del elemento con el handle dado (en la
+// cola) en O(log n), por ejemplo para aumentar la prioridad de un nodo en
+// Dijkstra. El elemento conserva su orden de inserción para los empates.
+void pqueue_update(PQueue *queue, int handle, int priority);
+
+// Esta función inserta n elementos de una vez (prioridad priorities[i] para
+// datos[i]) y reordena el montículo completo en O(n + tamaño de la cola), en
+// vez de O(n log n) insertándolos uno a uno.
+void pqueue_heapify(PQueue *queue, const int *priorities, void **datos, int n);
+
+// Esta función elimina y retorna el elemento de mayor prioridad, o NULL si la
+// cola está vacía. Toma O(log n).
 void *pqueue_remove(PQueue *queue);
 
+// Esta función retorna el elemento de mayor prioridad sin eliminarlo, o NULL
+// si la cola está vacía.
 void *pqueue_front(PQueue *queue);
 
+// Esta función retorna el número de elementos de la cola.
+int pqueue_size(PQueue *queue);
+
+// Esta función elimina todos los elementos de la cola (no los datos a los que
+// apuntan). La cola se libera luego con free.
 void pqueue_clean(PQueue *queue);
 
-#endif /* QUEUE_H */
\ No newline at end of file
+#endif /* PQUEUE_H */
@@ -0,0 +1,157 @@
+#include "string_pool.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define SLOT_VACIO -1
+#define MIN_SLOTS 64
+#define TAM_BLOQUE 65536 // Bytes de cada bloque donde se copian las cadenas
+
+struct StringPool {
+  char **strings;        // cadena de cada id
+  unsigned long *hashes; // hash de cada id, para no recalcularlo
+  int size;              // número de cadenas
+  int capacity;          // capacidad de strings y hashes
+
+  int *slots; // tabla de direccionamiento abierto con ids (o SLOT_VACIO)
+  int nslots; // siempre potencia de 2
+
+  // Las cadenas se copian en bloques grandes que nunca se mueven, así los
+  // punteros de strpool_get son estables y se evita un malloc por cadena
+  char **bloques;
+  int nbloques;
+  int cap_bloques;
+  size_t usado; // bytes usados del último bloque
+  size_t libre; // bytes libres del último bloque
+};
+
+static unsigned long _hash(const char *str) {
+  unsigned long h = 14695981039346656037UL;
+  for (const unsigned char *c = (const unsigned char *)str; *c; c++) {
+    h ^= *c;
+    h *= 1099511628211UL;
+  }
+  return h;
+}
+
+StringPool *strpool_create() {
+  StringPool *pool = (StringPool *)calloc(1, sizeof(StringPool));
+  return pool; // NULL si falla la asignación de memoria
+}
+
+static int _find_slot(StringPool *pool, const char *str, unsigned long h) {
+  if (pool->nslots == 0)
+    return -1;
+  int mask = pool->nslots - 1;
+  for (int i = (int)(h & mask);; i = (i + 1) & mask) {
+    int id = pool->slots[i];
+    if (id == SLOT_VACIO || (pool->hashes[id] == h &&
+                             strcmp(pool->strings[id], str) == 0))
+      return i;
+  }
+}
+
+static int _rehash(StringPool *pool) {
+  int nslots = pool->nslots ? pool->nslots * 2 : MIN_SLOTS;
+  int *slots = (int *)malloc(nslots * sizeof(int));
+  if (slots == NULL)
+    return 0;
+  for (int i = 0; i < nslots; i++)
+    slots[i] = SLOT_VACIO;
+  int mask = nslots - 1;
+  for (int id = 0; id < pool->size; id++) {
+    int s = (int)(pool->hashes[id] & mask);
+    while (slots[s] != SLOT_VACIO)
+      s = (s + 1) & mask;
+    slots[s] = id;
+  }
+  free(pool->slots);
+  pool->slots = slots;
+  pool->nslots = nslots;
+  return 1;
+}
+
+// Copia la cadena (con su '\0') a los bloques del conjunto
+static char *_copiar(StringPool *pool, const char *str) {
+  size_t largo = strlen(str) + 1;
+  if (largo > pool->libre) {
+    if (pool->nbloques == pool->cap_bloques) {
+      int cap = pool->cap_bloques ? pool->cap_bloques * 2 : 8;
+      char **bloques = (char **)realloc(pool->bloques, cap * sizeof(char *));
+      if (bloques == NULL)
+        return NULL;
+      pool->bloques = bloques;
+      pool->cap_bloques = cap;
+    }
+    size_t tam = largo > TAM_BLOQUE ? largo : TAM_BLOQUE;
+    char *bloque = (char *)malloc(tam);
+    if (bloque == NULL)
+      return NULL;
+    pool->bloques[pool->nbloques++] = bloque;
+    pool->usado = 0;
+    pool->libre = tam;
+  }
+  char *copia = pool->bloques[pool->nbloques - 1] + pool->usado;
+  memcpy(copia, str, largo);
+  pool->usado += largo;
+  pool->libre -= largo;
+  return copia;
+}
+
+int strpool_intern(StringPool *pool, const char *str) {
+  unsigned long h = _hash(str);
+  int s = _find_slot(pool, str, h);
+  if (s != -1 && pool->slots[s] != SLOT_VACIO)
+    return pool->slots[s];
+
+  // Mantiene el factor de carga por debajo de 0.5
+  if ((pool->size + 1) * 2 > pool->nslots) {
+    if (!_rehash(pool))
+      return -1;
+    s = _find_slot(pool, str, h);
+  }
+  if (pool->size == pool->capacity) {
+    int cap = pool->capacity ? pool->capacity * 2 : 64;
+    char **strings = (char **)realloc(pool->strings, cap * sizeof(char *));
+    if (strings == NULL)
+      return -1;
+    pool->strings = strings;
+    unsigned long *hashes =
+        (unsigned long *)realloc(pool->hashes, cap * sizeof(unsigned long));
+    if (hashes == NULL)
+      return -1;
+    pool->hashes = hashes;
+    pool->capacity = cap;
+  }
+
+  char *copia = _copiar(pool, str);
+  if (copia == NULL)
+    return -1;
+  int id = pool->size++;
+  pool->strings[id] = copia;
+  pool->hashes[id] = h;
+  pool->slots[s] = id;
+  return id;
+}
+
+int strpool_find(StringPool *pool, const char *str) {
+  int s = _find_slot(pool, str, _hash(str));
+  return s == -1 ? -1 : pool->slots[s];
+}
+
+const char *strpool_get(StringPool *pool, int id) {
+  if (id < 0 || id >= pool->size)
+    return NULL;
+  return pool->strings[id];
+}
+
+int strpool_size(StringPool *pool) { return pool->size; }
+
+void strpool_clean(StringPool *pool) {
+  for (int i = 0; i < pool->nbloques; i++)
+    free(pool->bloques[i]);
+  free(pool->bloques);
+  free(pool->strings);
+  free(pool->hashes);
+  free(pool->slots);
+  memset(pool, 0, sizeof(StringPool));
+}
@@ -0,0 +1,29 @@
+#ifndef STRING_POOL_H
+#define STRING_POOL_H
+
+typedef struct StringPool StringPool;
+
+// Esta función crea un conjunto de cadenas internadas vacío. Cada cadena
+// distinta se guarda una sola vez y recibe un id entero (0, 1, 2, ...), por lo
+// que dos cadenas son iguales si y solo si tienen el mismo id (o el mismo
+// puntero retornado por strpool_get).
+StringPool *strpool_create();
+
+// Esta función retorna el id de la cadena, copiándola al conjunto si no
+// estaba. Retorna -1 si falla la asignación de memoria.
+int strpool_intern(StringPool *pool, const char *str);
+
+// Esta función retorna el id de la cadena, o -1 si no está en el conjunto.
+int strpool_find(StringPool *pool, const char *str);
+
+// Esta función retorna la cadena con el id dado. El puntero es válido (y no
+// cambia) hasta llamar a strpool_clean.
+const char *strpool_get(StringPool *pool, int id);
+
+// Esta función retorna el número de cadenas distintas del conjunto.
+int strpool_size(StringPool *pool);
+
+// Esta función elimina todas las cadenas del conjunto.
+void strpool_clean(StringPool *pool);
+
+#endif /* STRING_POOL_H */
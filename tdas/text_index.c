@@ -0,0 +1,308 @@
+#include "text_index.h"
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Cada documento se guarda en el texto como MARCA_INICIO, el documento y
+// '\0'. Un sufijo termina en el '\0' de su documento, así que comparar sufijos
+// con strcmp nunca pasa a otro documento, y los sufijos que empiezan con la
+// marca permiten buscar por prefijo con el mismo arreglo.
+#define MARCA_INICIO '\1'
+
+// Tamaño bajo el cual los grupos se ordenan por inserción
+#define MIN_PARTICION 16
+
+struct TextIndex {
+  char *texto;
+  uint32_t *inicio;   // posición de la marca de cada documento
+  int n;              // documentos
+  uint32_t *sufijos;  // posiciones de los sufijos, en orden lexicográfico
+  size_t n_sufijos;
+};
+
+/* ---------- Construcción ---------- */
+
+static void _swap(uint32_t *a, uint32_t *b) {
+  uint32_t t = *a;
+  *a = *b;
+  *b = t;
+}
+
+/**
+ * Ordena n sufijos que comparten sus primeros d caracteres con quicksort de
+ * tres vías por caracteres (Bentley-Sedgewick): cada paso separa los sufijos
+ * según su carácter d y solo el grupo de los iguales avanza al carácter
+ * siguiente, así ningún carácter se compara más de una vez por sufijo en ese
+ * grupo.
+ */
+static void _sort_suffixes(const unsigned char *t, uint32_t *a, size_t n,
+                           size_t d) {
+  while (n > 1) {
+    if (n < MIN_PARTICION) {
+      for (size_t i = 1; i < n; i++)
+        for (size_t j = i; j > 0 && strcmp((const char *)t + a[j - 1] + d,
+                                           (const char *)t + a[j] + d) > 0;
+             j--)
+          _swap(&a[j - 1], &a[j]);
+      return;
+    }
+
+    // Pivote: mediana de tres caracteres
+    int x = t[a[0] + d], y = t[a[n / 2] + d], z = t[a[n - 1] + d];
+    int v = x < y ? (y < z ? y : (x < z ? z : x))
+                  : (x < z ? x : (y < z ? z : y));
+
+    size_t lt = 0, i = 0, gt = n;
+    while (i < gt) {
+      int c = t[a[i] + d];
+      if (c < v)
+        _swap(&a[lt++], &a[i++]);
+      else if (c > v)
+        _swap(&a[i], &a[--gt]);
+      else
+        i++;
+    }
+    _sort_suffixes(t, a, lt, d);
+    _sort_suffixes(t, a + gt, n - gt, d);
+    if (v == 0)
+      return; // Los iguales terminan aquí: son el mismo sufijo
+    a += lt;
+    n = gt - lt;
+    d++;
+  }
+}
+
+// Grupo de sufijos con los mismos dos primeros caracteres
+typedef struct {
+  size_t inicio, tam;
+  int termina; // 1 si el segundo carácter es '\0' (sufijos iguales)
+} Cubeta;
+
+typedef struct {
+  TextIndex *index;
+  Cubeta *cubetas;
+  int n_cubetas;
+  int siguiente; // Próxima cubeta por ordenar (se toma con una operación
+                 // atómica)
+} TrabajoOrden;
+
+// Cada hilo ordena cubetas hasta que no queden
+static void *_sort_worker(void *arg) {
+  TrabajoOrden *trabajo = arg;
+  const unsigned char *t = (const unsigned char *)trabajo->index->texto;
+  int c;
+  while ((c = __atomic_fetch_add(&trabajo->siguiente, 1, __ATOMIC_RELAXED)) <
+         trabajo->n_cubetas) {
+    Cubeta *cub = &trabajo->cubetas[c];
+    if (!cub->termina)
+      _sort_suffixes(t, trabajo->index->sufijos + cub->inicio, cub->tam, 2);
+  }
+  return NULL;
+}
+
+// Ordena las cubetas de mayor a menor, para repartir primero las grandes
+static int _larger_bucket(const void *a, const void *b) {
+  size_t x = ((const Cubeta *)a)->tam, y = ((const Cubeta *)b)->tam;
+  return x < y ? 1 : x > y ? -1 : 0;
+}
+
+/**
+ * Ordena los sufijos: primero se reparten en 65536 cubetas según sus dos
+ * primeros caracteres (ordenamiento por conteo) y luego cada cubeta se ordena
+ * por separado, repartidas entre los hilos.
+ */
+static int _build_suffixes(TextIndex *index, size_t largo, int hilos) {
+  const unsigned char *t = (const unsigned char *)index->texto;
+  size_t *cuentas = calloc(65536 + 1, sizeof(size_t));
+  index->sufijos = malloc((index->n_sufijos ? index->n_sufijos : 1) *
+                          sizeof(uint32_t));
+  Cubeta *cubetas = malloc(65536 * sizeof(Cubeta));
+  if (cuentas == NULL || index->sufijos == NULL || cubetas == NULL) {
+    free(cuentas);
+    free(cubetas);
+    return 0;
+  }
+
+  for (size_t p = 0; p < largo; p++)
+    if (t[p] != '\0')
+      cuentas[(t[p] << 8 | t[p + 1]) + 1]++;
+  for (int k = 0; k < 65536; k++)
+    cuentas[k + 1] += cuentas[k];
+  int n_cubetas = 0;
+  for (int k = 0; k < 65536; k++)
+    if (cuentas[k + 1] > cuentas[k])
+      cubetas[n_cubetas++] = (Cubeta){cuentas[k], cuentas[k + 1] - cuentas[k],
+                                      (k & 0xff) == 0};
+  for (size_t p = 0; p < largo; p++)
+    if (t[p] != '\0')
+      index->sufijos[cuentas[t[p] << 8 | t[p + 1]]++] = p;
+  free(cuentas);
+
+  qsort(cubetas, n_cubetas, sizeof(Cubeta), _larger_bucket);
+  TrabajoOrden trabajo = {index, cubetas, n_cubetas, 0};
+  if (hilos < 1)
+    hilos = 1;
+  pthread_t *ids = malloc(hilos * sizeof(pthread_t));
+  int lanzados = 0;
+  while (ids != NULL && lanzados < hilos - 1 &&
+         pthread_create(&ids[lanzados], NULL, _sort_worker, &trabajo) == 0)
+    lanzados++;
+  _sort_worker(&trabajo);
+  for (int i = 0; i < lanzados; i++)
+    pthread_join(ids[i], NULL);
+  free(ids);
+  free(cubetas);
+  return 1;
+}
+
+TextIndex *textindex_create(const char **textos, int n,
+                            void (*normalizar)(char *), int hilos) {
+  TextIndex *index = calloc(1, sizeof(TextIndex));
+  if (index == NULL)
+    return NULL;
+  size_t total = 1;
+  for (int i = 0; i < n; i++)
+    total += strlen(textos[i]) + 2;
+  if (total > UINT32_MAX) {
+    free(index);
+    return NULL;
+  }
+  index->texto = malloc(total);
+  index->inicio = malloc((n > 0 ? n : 1) * sizeof(uint32_t));
+  if (index->texto == NULL || index->inicio == NULL) {
+    textindex_clean(index);
+    free(index);
+    return NULL;
+  }
+
+  // Se copian los documentos (normalizados) uno tras otro
+  size_t largo = 0;
+  for (int i = 0; i < n; i++) {
+    index->inicio[i] = largo;
+    char *doc = index->texto + largo + 1;
+    index->texto[largo] = MARCA_INICIO;
+    strcpy(doc, textos[i]);
+    if (normalizar != NULL)
+      normalizar(doc);
+    largo += strlen(doc) + 2;
+  }
+  index->texto[largo] = '\0';
+  index->n = n;
+  index->n_sufijos = largo - n; // Todas las posiciones salvo los '\0'
+
+  if (!_build_suffixes(index, largo, hilos)) {
+    textindex_clean(index);
+    free(index);
+    return NULL;
+  }
+  return index;
+}
+
+/* ---------- Búsqueda ---------- */
+
+// Retorna la primera posición del arreglo de sufijos cuyo sufijo, recortado
+// al largo del patrón, es mayor (estricto = 1) o no menor (estricto = 0) que
+// el patrón
+static size_t _bound(TextIndex *index, const char *patron, size_t m,
+                     int estricto) {
+  size_t ini = 0, fin = index->n_sufijos;
+  while (ini < fin) {
+    size_t medio = ini + (fin - ini) / 2;
+    int c = strncmp(index->texto + index->sufijos[medio], patron, m);
+    if (c < 0 || (estricto && c == 0))
+      ini = medio + 1;
+    else
+      fin = medio;
+  }
+  return ini;
+}
+
+// Retorna el documento que contiene la posición p del texto
+static int _doc_at(TextIndex *index, uint32_t p) {
+  int ini = 0, fin = index->n;
+  while (fin - ini > 1) {
+    int medio = (ini + fin) / 2;
+    if (index->inicio[medio] <= p)
+      ini = medio;
+    else
+      fin = medio;
+  }
+  return ini;
+}
+
+static int _int_lower(const void *a, const void *b) {
+  int x = *(const int *)a, y = *(const int *)b;
+  return (x > y) - (x < y);
+}
+
+int textindex_search(TextIndex *index, const char *patron, int prefijo,
+                     int *docs) {
+  size_t m = strlen(patron);
+  if (m == 0) { // Todos los documentos contienen (y empiezan con) ""
+    for (int i = 0; i < index->n; i++)
+      docs[i] = i;
+    return index->n;
+  }
+
+  // Con prefijo se busca el patrón justo después de la marca de inicio
+  char *buscado = malloc(m + 2);
+  if (buscado == NULL)
+    return -1;
+  if (prefijo)
+    buscado[0] = MARCA_INICIO;
+  strcpy(buscado + (prefijo != 0), patron);
+  m += prefijo != 0;
+
+  size_t ini = _bound(index, buscado, m, 0);
+  size_t fin = _bound(index, buscado, m, 1);
+  free(buscado);
+  if (ini == fin)
+    return 0;
+
+  // Un documento puede contener el patrón más de una vez: con muchas
+  // apariciones se marcan los documentos y se recorren en orden; con pocas se
+  // ordenan los documentos de las apariciones y se eliminan los repetidos
+  size_t k = fin - ini;
+  int total = 0;
+  if (k > (size_t)index->n / 16) {
+    unsigned char *marcas = calloc(index->n, 1);
+    if (marcas == NULL)
+      return -1;
+    for (size_t i = ini; i < fin; i++)
+      marcas[_doc_at(index, index->sufijos[i])] = 1;
+    for (int d = 0; d < index->n; d++)
+      if (marcas[d])
+        docs[total++] = d;
+    free(marcas);
+    return total;
+  }
+  for (size_t i = 0; i < k; i++)
+    docs[i] = _doc_at(index, index->sufijos[ini + i]);
+  qsort(docs, k, sizeof(int), _int_lower);
+  for (size_t i = 0; i < k; i++)
+    if (total == 0 || docs[total - 1] != docs[i])
+      docs[total++] = docs[i];
+  return total;
+}
+
+int textindex_match(TextIndex *index, int doc, const char *patron,
+                    int prefijo) {
+  const char *texto = index->texto + index->inicio[doc] + 1;
+  if (prefijo)
+    return strncmp(texto, patron, strlen(patron)) == 0;
+  return strstr(texto, patron) != NULL;
+}
+
+int textindex_size(TextIndex *index) { return index->n; }
+
+void textindex_clean(TextIndex *index) {
+  free(index->texto);
+  free(index->inicio);
+  free(index->sufijos);
+  index->texto = NULL;
+  index->inicio = NULL;
+  index->sufijos = NULL;
+  index->n = 0;
+  index->n_sufijos = 0;
+}
@@ -0,0 +1,36 @@
+#ifndef TEXT_INDEX_H
+#define TEXT_INDEX_H
+
+typedef struct TextIndex TextIndex;
+
+// Esta función crea un índice de texto sobre n documentos (cadenas), que
+// quedan identificados por su posición (0 a n - 1). Si `normalizar` no es
+// NULL se aplica a la copia de cada documento (en el mismo lugar, sin
+// alargarla), y las búsquedas deben hacerse con patrones ya normalizados. El
+// índice es un arreglo de sufijos de todos los documentos, que se ordena con
+// hasta `hilos` hilos. Los documentos no deben contener el carácter '\1', que
+// marca su comienzo. Retorna NULL si falla la asignación de memoria o el texto
+// pasa de 4 GB.
+TextIndex *textindex_create(const char **textos, int n,
+                            void (*normalizar)(char *), int hilos);
+
+// Esta función deja en `docs` (con espacio para todos los documentos) los
+// documentos que contienen el patrón, o que empiezan con él si `prefijo` es
+// 1, en orden creciente y sin repetir. Retorna cuántos son, o -1 si falla la
+// asignación de memoria. Toma O(m log N + k log k), con m el largo del
+// patrón, N el largo total del texto y k el número de apariciones.
+int textindex_search(TextIndex *index, const char *patron, int prefijo,
+                     int *docs);
+
+// Esta función retorna 1 si el documento contiene el patrón (o empieza con él
+// si `prefijo` es 1), 0 de lo contrario.
+int textindex_match(TextIndex *index, int doc, const char *patron,
+                    int prefijo);
+
+// Esta función retorna el número de documentos del índice.
+int textindex_size(TextIndex *index);
+
+// Esta función elimina el texto y el arreglo de sufijos del índice.
+void textindex_clean(TextIndex *index);
+
+#endif /* TEXT_INDEX_H */
@@ -0,0 +1,334 @@
+#include "trigram_index.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Los trigramas se agrupan en 2^BITS_CUBETA cubetas según su hash. Dos
+// trigramas de la misma cubeta comparten lista, lo que solo agrega candidatos
+// que luego se descartan al contar los errores.
+#define BITS_CUBETA 18
+#define N_CUBETAS (1 << BITS_CUBETA)
+
+struct TrigramIndex {
+  char *texto;             // documentos seguidos, cada uno con su '\0'
+  size_t *inicio;          // posición de cada documento en el texto
+  int n;                   // documentos
+  uint32_t *inicio_listas; // lista de la cubeta b: [inicio_listas[b],
+                           // inicio_listas[b + 1]) en listas
+  int *listas;             // documentos de cada cubeta, en orden creciente
+};
+
+static uint32_t _bucket(const unsigned char *s) {
+  uint32_t trigrama = (uint32_t)s[0] << 16 | (uint32_t)s[1] << 8 | s[2];
+  return (trigrama * 2654435761u) >> (32 - BITS_CUBETA);
+}
+
+static int _uint_lower(const void *a, const void *b) {
+  uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+  return (x > y) - (x < y);
+}
+
+/**
+ * Deja en `cubetas` (con espacio para strlen(s) valores) las cubetas de los
+ * trigramas de un patrón, ordenadas y sin repetir, y retorna cuántas son.
+ */
+static int _pattern_buckets(const char *s, uint32_t *cubetas) {
+  const unsigned char *t = (const unsigned char *)s;
+  size_t largo = strlen(s);
+  if (largo < 3)
+    return 0;
+  int n = 0;
+  for (size_t i = 0; i + 2 < largo; i++)
+    cubetas[n++] = _bucket(t + i);
+  if (n < 16) {
+    for (int i = 1; i < n; i++)
+      for (int j = i; j > 0 && cubetas[j - 1] > cubetas[j]; j--) {
+        uint32_t x = cubetas[j];
+        cubetas[j] = cubetas[j - 1];
+        cubetas[j - 1] = x;
+      }
+  } else {
+    qsort(cubetas, n, sizeof(uint32_t), _uint_lower);
+  }
+  int distintas = 0;
+  for (int i = 0; i < n; i++)
+    if (distintas == 0 || cubetas[distintas - 1] != cubetas[i])
+      cubetas[distintas++] = cubetas[i];
+  return distintas;
+}
+
+/* ---------- Construcción ---------- */
+
+TrigramIndex *trigram_create(const char **textos, int n,
+                             void (*normalizar)(char *)) {
+  TrigramIndex *index = calloc(1, sizeof(TrigramIndex));
+  if (index == NULL)
+    return NULL;
+  size_t total = 1;
+  for (int i = 0; i < n; i++)
+    total += strlen(textos[i]) + 1;
+  index->texto = malloc(total);
+  index->inicio = malloc((n > 0 ? n : 1) * sizeof(size_t));
+  index->inicio_listas = calloc(N_CUBETAS + 1, sizeof(uint32_t));
+  // Último documento agregado a cada cubeta, para no repetirlo en su lista
+  int *visto = malloc(N_CUBETAS * sizeof(int));
+  if (index->texto == NULL || index->inicio == NULL ||
+      index->inicio_listas == NULL || visto == NULL) {
+    free(visto);
+    trigram_clean(index);
+    free(index);
+    return NULL;
+  }
+
+  // Se copian los documentos (normalizados) y se cuenta cuántos documentos
+  // tiene cada cubeta
+  memset(visto, 0xff, N_CUBETAS * sizeof(int));
+  size_t largo = 0, n_entradas = 0;
+  for (int i = 0; i < n; i++) {
+    char *doc = index->texto + largo;
+    index->inicio[i] = largo;
+    strcpy(doc, textos[i]);
+    if (normalizar != NULL)
+      normalizar(doc);
+    size_t l = strlen(doc);
+    for (size_t p = 0; p + 2 < l; p++) {
+      uint32_t b = _bucket((const unsigned char *)doc + p);
+      if (visto[b] != i) {
+        visto[b] = i;
+        index->inicio_listas[b + 1]++;
+        n_entradas++;
+      }
+    }
+    largo += l + 1;
+  }
+  index->n = n;
+  if (n_entradas > UINT32_MAX) {
+    free(visto);
+    trigram_clean(index);
+    free(index);
+    return NULL;
+  }
+
+  // Ordenamiento por conteo: cada documento se agrega a las listas de sus
+  // cubetas, que quedan en orden creciente de documento
+  for (int b = 0; b < N_CUBETAS; b++)
+    index->inicio_listas[b + 1] += index->inicio_listas[b];
+  index->listas = malloc((n_entradas > 0 ? n_entradas : 1) * sizeof(int));
+  uint32_t *siguiente = malloc(N_CUBETAS * sizeof(uint32_t));
+  if (index->listas == NULL || siguiente == NULL) {
+    free(siguiente);
+    free(visto);
+    trigram_clean(index);
+    free(index);
+    return NULL;
+  }
+  memcpy(siguiente, index->inicio_listas, N_CUBETAS * sizeof(uint32_t));
+  memset(visto, 0xff, N_CUBETAS * sizeof(int));
+  for (int i = 0; i < n; i++) {
+    const unsigned char *doc =
+        (const unsigned char *)index->texto + index->inicio[i];
+    for (size_t p = 0; doc[p] != '\0' && doc[p + 1] != '\0' &&
+                       doc[p + 2] != '\0';
+         p++) {
+      uint32_t b = _bucket(doc + p);
+      if (visto[b] != i) {
+        visto[b] = i;
+        index->listas[siguiente[b]++] = i;
+      }
+    }
+  }
+  free(siguiente);
+  free(visto);
+  return index;
+}
+
+/* ---------- Búsqueda ---------- */
+
+/**
+ * Errores con que `texto` contiene un patrón de m bytes (1 a 64), con el
+ * algoritmo paralelo de bits de Myers: la columna de la distancia de edición
+ * se guarda como diferencias entre filas vecinas (+1, 0 o -1) en dos máscaras
+ * de 64 bits, y cada byte del texto la actualiza con unas pocas operaciones.
+ * `eq[c]` tiene un 1 en las posiciones del patrón donde está el byte c.
+ */
+static int _errors_bits(const char *texto, const uint64_t *eq, size_t m) {
+  uint64_t pv = ~(uint64_t)0, mv = 0, ultimo = (uint64_t)1 << (m - 1);
+  int errores = m, mejor = m;
+  for (const unsigned char *c = (const unsigned char *)texto;
+       *c != '\0' && mejor > 0; c++) {
+    uint64_t x = eq[*c];
+    uint64_t xv = x | mv;
+    uint64_t xh = (((x & pv) + pv) ^ pv) | x;
+    uint64_t ph = mv | ~(xh | pv);
+    uint64_t mh = pv & xh;
+    if (ph & ultimo)
+      errores++;
+    else if (mh & ultimo)
+      errores--;
+    // El comienzo en el texto es libre: la fila 0 vale 0 en todas partes
+    ph <<= 1;
+    mh <<= 1;
+    pv = mh | ~(xv | ph);
+    mv = ph & xv;
+    if (errores < mejor)
+      mejor = errores;
+  }
+  return mejor;
+}
+
+// Deja en eq las máscaras de _errors_bits para un patrón de m bytes
+static void _pattern_masks(const char *patron, size_t m, uint64_t *eq) {
+  memset(eq, 0, 256 * sizeof(uint64_t));
+  for (size_t i = 0; i < m; i++)
+    eq[(unsigned char)patron[i]] |= (uint64_t)1 << i;
+}
+
+/**
+ * Errores con que `texto` contiene un patrón de cualquier largo, llenando la
+ * columna completa de la distancia de edición por cada byte del texto.
+ */
+static int _errors_column(const char *texto, const char *patron, size_t m) {
+  // columna[i] es el menor número de errores con que los primeros i bytes
+  // del patrón terminan en la posición actual del texto
+  int *columna = malloc((m + 1) * sizeof(int));
+  if (columna == NULL)
+    return -1;
+  for (size_t i = 0; i <= m; i++)
+    columna[i] = i;
+  int mejor = m;
+  for (const char *c = texto; *c != '\0' && mejor > 0; c++) {
+    int diagonal = columna[0];
+    for (size_t i = 1; i <= m; i++) {
+      int arriba = columna[i];
+      int valor = diagonal + (patron[i - 1] != *c);
+      if (arriba + 1 < valor)
+        valor = arriba + 1;
+      if (columna[i - 1] + 1 < valor)
+        valor = columna[i - 1] + 1;
+      columna[i] = valor;
+      diagonal = arriba;
+    }
+    if (columna[m] < mejor)
+      mejor = columna[m];
+  }
+  free(columna);
+  return mejor;
+}
+
+int trigram_errors(const char *texto, const char *patron, int max_errores) {
+  size_t m = strlen(patron);
+  int errores;
+  if (m == 0) {
+    errores = 0;
+  } else if (m <= 64) {
+    uint64_t eq[256];
+    _pattern_masks(patron, m, eq);
+    errores = _errors_bits(texto, eq, m);
+  } else {
+    errores = _errors_column(texto, patron, m);
+  }
+  return errores != -1 && errores <= max_errores ? errores : -1;
+}
+
+int trigram_match(TrigramIndex *index, int doc, const char *patron,
+                  int max_errores) {
+  return trigram_errors(index->texto + index->inicio[doc], patron,
+                        max_errores);
+}
+
+typedef struct {
+  int errores, doc;
+} Coincidencia;
+
+static int _fewer_errors(const void *a, const void *b) {
+  const Coincidencia *x = a, *y = b;
+  if (x->errores != y->errores)
+    return x->errores - y->errores;
+  return (x->doc > y->doc) - (x->doc < y->doc);
+}
+
+/**
+ * Deja en `docs` los documentos que comparten al menos `umbral` cubetas con
+ * las del patrón y retorna cuántos son. Cada error cambia a lo más 3
+ * trigramas del patrón, así que un documento con pocos errores comparte casi
+ * todas sus cubetas.
+ */
+static int _candidates(TrigramIndex *index, const uint32_t *cubetas, int k,
+                       int umbral, int *docs) {
+  if (umbral > UINT16_MAX)
+    umbral = UINT16_MAX; // Menos exigente, pero sigue siendo correcto
+  uint16_t *cuentas = calloc(index->n > 0 ? index->n : 1, sizeof(uint16_t));
+  if (cuentas == NULL)
+    return -1;
+  int total = 0;
+  for (int j = 0; j < k; j++)
+    for (uint32_t e = index->inicio_listas[cubetas[j]];
+         e < index->inicio_listas[cubetas[j] + 1]; e++) {
+      int d = index->listas[e];
+      if (cuentas[d] < umbral && ++cuentas[d] == umbral)
+        docs[total++] = d;
+    }
+  free(cuentas);
+  return total;
+}
+
+int trigram_search(TrigramIndex *index, const char *patron, int max_errores,
+                   int *docs, int *errores) {
+  if (max_errores < 0)
+    max_errores = 0;
+  uint32_t *cubetas = malloc((strlen(patron) + 1) * sizeof(uint32_t));
+  if (cubetas == NULL)
+    return -1;
+  int k = _pattern_buckets(patron, cubetas);
+  int umbral = k - 3 * max_errores;
+  int n;
+  if (umbral >= 1) {
+    n = _candidates(index, cubetas, k, umbral, docs);
+  } else { // El filtro no descarta nada: se revisan todos los documentos
+    for (n = 0; n < index->n; n++)
+      docs[n] = n;
+  }
+  free(cubetas);
+  if (n == -1)
+    return -1;
+
+  // Se cuentan los errores de cada candidato y se ordenan los que quedan
+  Coincidencia *encontradas = malloc((n > 0 ? n : 1) * sizeof(Coincidencia));
+  if (encontradas == NULL)
+    return -1;
+  int total = 0;
+  size_t m = strlen(patron);
+  uint64_t eq[256];
+  if (m > 0 && m <= 64)
+    _pattern_masks(patron, m, eq);
+  for (int i = 0; i < n; i++) {
+    const char *doc = index->texto + index->inicio[docs[i]];
+    int e = m == 0 ? 0
+            : m <= 64 ? _errors_bits(doc, eq, m)
+                      : _errors_column(doc, patron, m);
+    if (e != -1 && e <= max_errores)
+      encontradas[total++] = (Coincidencia){e, docs[i]};
+  }
+  qsort(encontradas, total, sizeof(Coincidencia), _fewer_errors);
+  for (int i = 0; i < total; i++) {
+    docs[i] = encontradas[i].doc;
+    if (errores != NULL)
+      errores[i] = encontradas[i].errores;
+  }
+  free(encontradas);
+  return total;
+}
+
+int trigram_size(TrigramIndex *index) { return index->n; }
+
+void trigram_clean(TrigramIndex *index) {
+  free(index->texto);
+  free(index->inicio);
+  free(index->inicio_listas);
+  free(index->listas);
+  index->texto = NULL;
+  index->inicio = NULL;
+  index->inicio_listas = NULL;
+  index->listas = NULL;
+  index->n = 0;
+}
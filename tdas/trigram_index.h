@@ -0,0 +1,42 @@
+#ifndef TRIGRAM_INDEX_H
+#define TRIGRAM_INDEX_H
+
+typedef struct TrigramIndex TrigramIndex;
+
+// Esta función crea un índice de trigramas (grupos de 3 bytes seguidos) sobre
+// n documentos (cadenas), que quedan identificados por su posición (0 a
+// n - 1), para búsquedas aproximadas. Si `normalizar` no es NULL se aplica a
+// la copia de cada documento (en el mismo lugar, sin alargarla), y las
+// búsquedas deben hacerse con patrones ya normalizados. Retorna NULL si falla
+// la asignación de memoria.
+TrigramIndex *trigram_create(const char **textos, int n,
+                             void (*normalizar)(char *));
+
+// Esta función deja en `docs` (con espacio para todos los documentos) los
+// documentos que contienen el patrón con a lo más `max_errores` errores
+// (caracteres insertados, borrados o cambiados), y en `errores` (si no es
+// NULL) cuántos tiene cada uno, ordenados de menos a más errores y luego por
+// documento. Solo se revisan los documentos que comparten suficientes
+// trigramas con el patrón; si el patrón tiene pocos trigramas para los
+// errores permitidos (3 * max_errores o menos) se revisan todos. Retorna
+// cuántos son, o -1 si falla la asignación de memoria.
+int trigram_search(TrigramIndex *index, const char *patron, int max_errores,
+                   int *docs, int *errores);
+
+// Esta función retorna los errores con que el documento contiene el patrón,
+// o -1 si son más de `max_errores`.
+int trigram_match(TrigramIndex *index, int doc, const char *patron,
+                  int max_errores);
+
+// Esta función retorna el menor número de errores con que `texto` contiene
+// `patron` (la distancia de edición del patrón a la parte más parecida del
+// texto), o -1 si son más de `max_errores`. No usa ningún índice.
+int trigram_errors(const char *texto, const char *patron, int max_errores);
+
+// Esta función retorna el número de documentos del índice.
+int trigram_size(TrigramIndex *index);
+
+// Esta función elimina los documentos y las listas del índice.
+void trigram_clean(TrigramIndex *index);
+
+#endif /* TRIGRAM_INDEX_H */
@@ -0,0 +1,248 @@
+#include "vector.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define MIN_CAPACIDAD 16
+// Los tramos de hasta este tamaño se ordenan por inserción
+#define TRAMO_CORTO 16
+
+struct Vector {
+  void **datos;
+  int size;
+  int capacity;
+  int current; // -1 si no hay elemento actual
+};
+
+typedef Vector Vector;
+
+Vector *vector_create() {
+  Vector *newVector = (Vector *)calloc(1, sizeof(Vector));
+  if (newVector == NULL) {
+    return NULL; // Fallo en la asignación de memoria
+  }
+  newVector->current = -1;
+  return newVector;
+}
+
+int vector_reserve(Vector *V, int n) {
+  if (V == NULL) {
+    return 0; // Vector no inicializado
+  }
+  if (n <= V->capacity) {
+    return 1;
+  }
+  int capacity = V->capacity ? V->capacity : MIN_CAPACIDAD;
+  while (capacity < n) {
+    capacity *= 2;
+  }
+  void **datos = (void **)realloc(V->datos, capacity * sizeof(void *));
+  if (datos == NULL) {
+    return 0; // Fallo en la asignación de memoria
+  }
+  V->datos = datos;
+  V->capacity = capacity;
+  return 1;
+}
+
+void vector_pushBack(Vector *V, void *dato) {
+  if (V == NULL || !vector_reserve(V, V->size + 1)) {
+    return; // Vector no inicializado o fallo en la asignación de memoria
+  }
+  V->datos[V->size++] = dato;
+}
+
+void *vector_popBack(Vector *V) {
+  if (V == NULL || V->size == 0) {
+    return NULL; // Vector vacío o no inicializado
+  }
+  if (V->current == V->size - 1) {
+    V->current = -1;
+  }
+  return V->datos[--V->size];
+}
+
+void *vector_get(Vector *V, int i) {
+  if (V == NULL || i < 0 || i >= V->size) {
+    return NULL; // Vector no inicializado o posición fuera de rango
+  }
+  return V->datos[i];
+}
+
+void vector_set(Vector *V, int i, void *dato) {
+  if (V == NULL || i < 0 || i >= V->size) {
+    return; // Vector no inicializado o posición fuera de rango
+  }
+  V->datos[i] = dato;
+}
+
+int vector_size(Vector *V) { return V == NULL ? 0 : V->size; }
+
+void **vector_data(Vector *V) { return V == NULL ? NULL : V->datos; }
+
+void *vector_first(Vector *V) {
+  if (V == NULL || V->size == 0) {
+    return NULL; // Vector vacío o no inicializado
+  }
+  V->current = 0;
+  return V->datos[0];
+}
+
+void *vector_next(Vector *V) {
+  if (V == NULL || V->current == -1 || V->current + 1 >= V->size) {
+    return NULL; // Vector no inicializado o no hay más elementos
+  }
+  return V->datos[++V->current];
+}
+
+void *vector_popCurrent(Vector *V) {
+  if (V == NULL || V->current == -1) {
+    return NULL; // Vector no inicializado o current no definido
+  }
+  int i = V->current;
+  void *dato = V->datos[i];
+  memmove(&V->datos[i], &V->datos[i + 1], (V->size - i - 1) * sizeof(void *));
+  V->size--;
+  if (i == V->size) {
+    V->current = -1; // Era el último: no queda un siguiente
+  }
+  return dato;
+}
+
+/* ---------- Ordenamiento ---------- */
+
+typedef int (*LowerThan)(void *data1, void *data2, void *ctx);
+
+static void _swap(void **a, void **b) {
+  void *t = *a;
+  *a = *b;
+  *b = t;
+}
+
+static void _insertion_sort(void **datos, int n, LowerThan lower_than,
+                            void *ctx) {
+  for (int i = 1; i < n; i++) {
+    void *dato = datos[i];
+    int j = i;
+    for (; j > 0 && lower_than(dato, datos[j - 1], ctx); j--) {
+      datos[j] = datos[j - 1];
+    }
+    datos[j] = dato;
+  }
+}
+
+static void _sift_down(void **datos, int i, int n, LowerThan lower_than,
+                       void *ctx) {
+  void *dato = datos[i];
+  while (2 * i + 1 < n) {
+    int hijo = 2 * i + 1;
+    if (hijo + 1 < n && lower_than(datos[hijo], datos[hijo + 1], ctx)) {
+      hijo++;
+    }
+    if (!lower_than(dato, datos[hijo], ctx)) {
+      break;
+    }
+    datos[i] = datos[hijo];
+    i = hijo;
+  }
+  datos[i] = dato;
+}
+
+static void _heap_sort(void **datos, int n, LowerThan lower_than,
+                       void *ctx) {
+  for (int i = n / 2 - 1; i >= 0; i--) {
+    _sift_down(datos, i, n, lower_than, ctx);
+  }
+  for (int i = n - 1; i > 0; i--) {
+    _swap(&datos[0], &datos[i]);
+    _sift_down(datos, 0, i, lower_than, ctx);
+  }
+}
+
+/**
+ * Introsort: quicksort con pivote mediana de tres que pasa a heapsort si la
+ * recursión se hace demasiado profunda (O(n log n) en el peor caso) y deja
+ * los tramos cortos para el ordenamiento por inserción final.
+ */
+static void _introsort(void **datos, int n, int profundidad,
+                       LowerThan lower_than, void *ctx) {
+  while (n > TRAMO_CORTO) {
+    if (profundidad-- == 0) {
+      _heap_sort(datos, n, lower_than, ctx);
+      return;
+    }
+    // Mediana de tres: deja datos[0] <= datos[medio] <= datos[n - 1]
+    int medio = n / 2;
+    if (lower_than(datos[medio], datos[0], ctx))
+      _swap(&datos[medio], &datos[0]);
+    if (lower_than(datos[n - 1], datos[medio], ctx)) {
+      _swap(&datos[n - 1], &datos[medio]);
+      if (lower_than(datos[medio], datos[0], ctx))
+        _swap(&datos[medio], &datos[0]);
+    }
+    void *pivote = datos[medio];
+
+    // Partición de Hoare: los extremos ya sirven de centinelas
+    int i = 0, j = n - 1;
+    while (1) {
+      do {
+        i++;
+      } while (lower_than(datos[i], pivote, ctx));
+      do {
+        j--;
+      } while (lower_than(pivote, datos[j], ctx));
+      if (i >= j)
+        break;
+      _swap(&datos[i], &datos[j]);
+    }
+
+    // Se recurre en la parte más chica y se itera en la más grande, para que
+    // la pila no pase de O(log n)
+    if (j + 1 < n - j - 1) {
+      _introsort(datos, j + 1, profundidad, lower_than, ctx);
+      datos += j + 1;
+      n -= j + 1;
+    } else {
+      _introsort(datos + j + 1, n - j - 1, profundidad, lower_than, ctx);
+      n = j + 1;
+    }
+  }
+}
+
+void vector_sort_ctx(Vector *V,
+                     int (*lower_than)(void *data1, void *data2, void *ctx),
+                     void *ctx) {
+  if (V == NULL || V->size < 2) {
+    return; // Vector no inicializado o ya ordenado
+  }
+  int profundidad = 0;
+  for (int n = V->size; n > 1; n >>= 1) {
+    profundidad += 2;
+  }
+  _introsort(V->datos, V->size, profundidad, lower_than, ctx);
+  _insertion_sort(V->datos, V->size, lower_than, ctx);
+}
+
+// Comparador sin contexto, que vector_sort pasa como contexto
+typedef struct {
+  int (*lower_than)(void *data1, void *data2);
+} ComparadorSimple;
+
+static int _lower_than_simple(void *data1, void *data2, void *ctx) {
+  return ((ComparadorSimple *)ctx)->lower_than(data1, data2);
+}
+
+void vector_sort(Vector *V, int (*lower_than)(void *data1, void *data2)) {
+  ComparadorSimple comparador = {lower_than};
+  vector_sort_ctx(V, _lower_than_simple, &comparador);
+}
+
+void vector_clean(Vector *V) {
+  if (V == NULL) {
+    return; // Vector no inicializado
+  }
+  free(V->datos);
+  V->datos = NULL;
+  V->size = 0;
+  V->capacity = 0;
+  V->current = -1;
+}
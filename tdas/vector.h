@@ -0,0 +1,66 @@
+#ifndef VECTOR_H
+#define VECTOR_H
+
+// Arreglo dinámico de punteros: los elementos quedan seguidos en memoria, por
+// lo que recorrerlo no salta de nodo en nodo como una List y se puede acceder
+// a cualquier posición en O(1).
+typedef struct Vector Vector;
+
+// Esta función crea un vector vacío y devuelve un puntero al vector, o NULL si
+// falla la asignación de memoria.
+Vector *vector_create();
+
+// Esta función asegura espacio para `n` elementos en total, para llenar el
+// vector sin que crezca varias veces. Retorna 0 si falla la asignación de
+// memoria.
+int vector_reserve(Vector *V, int n);
+
+// Esta función inserta un nuevo elemento al final del vector, en O(1)
+// amortizado.
+void vector_pushBack(Vector *V, void *dato);
+
+// Esta función elimina el último elemento del vector y lo retorna, o NULL si
+// está vacío.
+void *vector_popBack(Vector *V);
+
+// Esta función retorna el elemento de la posición i (0 a size - 1), o NULL si
+// la posición no existe.
+void *vector_get(Vector *V, int i);
+
+// Esta función reemplaza el elemento de la posición i (0 a size - 1).
+void vector_set(Vector *V, int i, void *dato);
+
+// Esta función retorna el número de elementos del vector.
+int vector_size(Vector *V);
+
+// Esta función retorna el arreglo con los elementos del vector (size de
+// ellos), para recorrerlos directamente. Deja de ser válido al insertar.
+void **vector_data(Vector *V);
+
+// Esta función devuelve el primer elemento del vector, que pasa a ser el
+// actual, como list_first.
+void *vector_first(Vector *V);
+
+// Esta función mueve el actual al siguiente elemento y lo devuelve, como
+// list_next.
+void *vector_next(Vector *V);
+
+// Esta función elimina el elemento actual manteniendo el orden de los demás
+// (en O(n), porque corre los siguientes); el siguiente pasa a ser el actual.
+void *vector_popCurrent(Vector *V);
+
+// Esta función ordena el vector en el mismo lugar de acuerdo a la función
+// lower_than, en O(n log n). El orden de los elementos iguales no se conserva.
+void vector_sort(Vector *V, int (*lower_than)(void *data1, void *data2));
+
+// Esta función ordena el vector como vector_sort, con un comparador que
+// recibe además el puntero `ctx`.
+void vector_sort_ctx(Vector *V,
+                     int (*lower_than)(void *data1, void *data2, void *ctx),
+                     void *ctx);
+
+// Esta función elimina todos los elementos del vector (no los datos a los que
+// apuntan). El vector se libera luego con free.
+void vector_clean(Vector *V);
+
+#endif /* VECTOR_H */